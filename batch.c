@@ -0,0 +1,739 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include "batch.h"
+#include "bmp8.h"
+#include "bmp24.h"
+#include "filtres.h"
+#include "memoire.h"
+
+#ifndef _WIN32
+#include <glob.h>
+#endif
+
+// Taille maximale d'un chemin de sortie
+#define BATCH_PATH_MAX 4096
+
+/*
+Table des opérations reconnues : nom sur la ligne de commande, paramètre obligatoire ou non
+*/
+static const struct {
+    const char *name;
+    t_batch_opType type;
+    int needsValue;
+} batch_opNames[] = {
+    {"info",       OP_INFO,          0},
+    {"negative",   OP_NEGATIVE,      0},
+    {"brightness", OP_BRIGHTNESS,    1},
+    {"threshold",  OP_THRESHOLD,     1},
+    {"grayscale",  OP_GRAYSCALE,     0},
+    {"box",        OP_BOX_BLUR,      0},
+    {"gaussian",   OP_GAUSSIAN_BLUR, 0},
+    {"outline",    OP_OUTLINE,       0},
+    {"emboss",     OP_EMBOSS,        0},
+    {"sharpen",    OP_SHARPEN,       0},
+    {"equalize",   OP_EQUALIZE,      0},
+    {"blur",       OP_SOFT_BLUR,     1},
+    {"clahe",      OP_CLAHE,         0}
+};
+
+#define BATCH_OP_COUNT (int)(sizeof(batch_opNames) / sizeof(batch_opNames[0]))
+
+/*
+Affiche l'aide du mode batch
+*/
+void batch_usage(const char *program) {
+    printf("Utilisation : %s [options] -p OP[=VALEUR] [-p ...] FICHIERS...\n", program);
+    printf("Sans argument, lance le menu interactif.\n\n");
+    printf("Options :\n");
+    printf("  -p, --op OP[=VALEUR]  operation a appliquer (dans l'ordre donne)\n");
+    printf("  -o, --output MOTIF    fichier de sortie, {name} = nom sans extension, {index} = numero\n");
+    printf("  -j, --jobs N          nombre de fichiers filtres en parallele (defaut 1)\n");
+    printf("      --readers N       threads de chargement (defaut 1)\n");
+    printf("      --writers N       threads de sauvegarde (defaut 1)\n");
+    printf("      --queue N         images en attente entre deux etapes (defaut %d)\n", BATCH_DEFAULT_QUEUE_DEPTH);
+    printf("  -t, --threads N       threads des filtres (defaut : nombre de processeurs)\n");
+    printf("  -m, --mapped          chargement par projection memoire\n");
+    printf("  -b, --border MODE     bords des filtres : clamp (defaut), reflect, wrap, constant[=V]\n");
+    printf("      --pool MO         cache du pool d'allocation en Mo (defaut %d, 0 : allocateur systeme)\n",
+           MEMORY_POOL_DEFAULT_CACHE_MB);
+    printf("  -h, --help            affiche cette aide\n\n");
+    printf("Operations : info, negative, brightness=V, threshold=T (8 bits), grayscale (24 bits),\n");
+    printf("             box[=R], gaussian[=R] (rayon R, defaut 3x3), outline, emboss, sharpen, equalize,\n");
+    printf("             blur=S (flou gaussien recursif d'ecart type S, pour les grands flous),\n");
+    printf("             clahe[=C] (egalisation adaptative 8 x 8 tuiles, limite C, defaut 2)\n");
+    printf("Exemple : %s -j 4 -p gaussian -p brightness=20 -o 'out/{name}_net.bmp' 'scans/*.bmp'\n", program);
+}
+
+/*
+Analyse une opération "nom" ou "nom=valeur"
+- blur exige un écart type strictement positif
+*/
+static int batch_parseOp(const char *text, t_batch_op *op) {
+    const char *eq = strchr(text, '=');
+    size_t nameLength = eq ? (size_t)(eq - text) : strlen(text);
+
+    for (int i = 0; i < BATCH_OP_COUNT; i++) {
+        if (strlen(batch_opNames[i].name) != nameLength || strncmp(batch_opNames[i].name, text, nameLength) != 0) {
+            continue;
+        }
+        if (batch_opNames[i].needsValue && !eq) {
+            printf("Erreur : l'operation %s attend une valeur (%s=VALEUR)\n", batch_opNames[i].name,
+                   batch_opNames[i].name);
+            return -1;
+        }
+        op->type = batch_opNames[i].type;
+        op->value = eq ? atoi(eq + 1) : 0;
+        if (op->type == OP_SOFT_BLUR && op->value <= 0) {
+            printf("Erreur : l'ecart type de blur doit etre un entier positif (%s)\n", text);
+            return -1;
+        }
+        return 0;
+    }
+
+    printf("Erreur : operation inconnue '%s'\n", text);
+    return -1;
+}
+
+/*
+Analyse un mode de bord "clamp", "reflect", "wrap" ou "constant[=niveau]"
+*/
+static int batch_parseBorder(const char *text, t_border *border) {
+    const char *eq = strchr(text, '=');
+    size_t nameLength = eq ? (size_t)(eq - text) : strlen(text);
+
+    for (int mode = BORDER_CLAMP; mode <= BORDER_CONSTANT; mode++) {
+        const char *name = borderModeName((t_borderMode)mode);
+        if (strlen(name) != nameLength || strncmp(name, text, nameLength) != 0) continue;
+        if (eq && mode != BORDER_CONSTANT) break;
+        border->mode = (t_borderMode)mode;
+        border->value = eq ? atoi(eq + 1) : 0;
+        return 0;
+    }
+
+    printf("Erreur : mode de bord inconnu '%s'\n", text);
+    return -1;
+}
+
+/*
+Ajoute un fichier d'entrée (ou tous les fichiers d'un motif glob)
+*/
+static int batch_addInput(t_batch_config *config, const char *pattern, int *capacity) {
+#ifndef _WIN32
+    glob_t matches;
+    int found = glob(pattern, 0, NULL, &matches) == 0;
+    size_t count = found ? matches.gl_pathc : 1;
+#else
+    size_t count = 1;
+#endif
+
+    for (size_t i = 0; i < count; i++) {
+#ifndef _WIN32
+        const char *path = found ? matches.gl_pathv[i] : pattern;
+#else
+        const char *path = pattern;
+#endif
+        if (config->inputCount == *capacity) {
+            *capacity = *capacity ? 2 * *capacity : 16;
+            char **grown = realloc(config->inputs, *capacity * sizeof(char *));
+            if (!grown) return -1;
+            config->inputs = grown;
+        }
+        config->inputs[config->inputCount] = malloc(strlen(path) + 1);
+        if (!config->inputs[config->inputCount]) return -1;
+        strcpy(config->inputs[config->inputCount], path);
+        config->inputCount++;
+    }
+
+#ifndef _WIN32
+    if (found) globfree(&matches);
+#endif
+    return 0;
+}
+
+/*
+Analyse la ligne de commande du mode batch
+*/
+int batch_parseArgs(int argc, char **argv, t_batch_config *config) {
+    memset(config, 0, sizeof(*config));
+    config->jobs = 1;
+    config->readers = 1;
+    config->writers = 1;
+    config->queueDepth = BATCH_DEFAULT_QUEUE_DEPTH;
+    config->poolCache = MEMORY_POOL_DEFAULT_CACHE_MB;
+
+    int inputCapacity = 0;
+    config->ops = malloc(argc * sizeof(t_batch_op));
+    if (!config->ops) return -1;
+
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        int hasValue = i + 1 < argc;
+
+        if (strcmp(arg, "-h") == 0 || strcmp(arg, "--help") == 0) {
+            batch_usage(argv[0]);
+            return -1;
+        } else if (strcmp(arg, "-m") == 0 || strcmp(arg, "--mapped") == 0) {
+            config->mapped = 1;
+        } else if ((strcmp(arg, "-p") == 0 || strcmp(arg, "--op") == 0) && hasValue) {
+            if (batch_parseOp(argv[++i], &config->ops[config->opCount]) != 0) return -1;
+            config->opCount++;
+        } else if ((strcmp(arg, "-o") == 0 || strcmp(arg, "--output") == 0) && hasValue) {
+            config->outputPattern = argv[++i];
+        } else if ((strcmp(arg, "-b") == 0 || strcmp(arg, "--border") == 0) && hasValue) {
+            if (batch_parseBorder(argv[++i], &config->border) != 0) return -1;
+        } else if ((strcmp(arg, "-j") == 0 || strcmp(arg, "--jobs") == 0) && hasValue) {
+            config->jobs = atoi(argv[++i]);
+        } else if ((strcmp(arg, "-t") == 0 || strcmp(arg, "--threads") == 0) && hasValue) {
+            config->threads = atoi(argv[++i]);
+        } else if (strcmp(arg, "--readers") == 0 && hasValue) {
+            config->readers = atoi(argv[++i]);
+        } else if (strcmp(arg, "--writers") == 0 && hasValue) {
+            config->writers = atoi(argv[++i]);
+        } else if (strcmp(arg, "--queue") == 0 && hasValue) {
+            config->queueDepth = atoi(argv[++i]);
+        } else if (strcmp(arg, "--pool") == 0 && hasValue) {
+            config->poolCache = atoi(argv[++i]);
+        } else if (arg[0] == '-') {
+            printf("Erreur : option inconnue ou incomplete '%s'\n", arg);
+            return -1;
+        } else if (batch_addInput(config, arg, &inputCapacity) != 0) {
+            printf("Erreur : echec allocation memoire\n");
+            return -1;
+        }
+    }
+
+    if (config->inputCount == 0) {
+        printf("Erreur : aucun fichier d'entree\n");
+        return -1;
+    }
+    if (config->opCount == 0 && !config->outputPattern) {
+        printf("Erreur : aucune operation (-p) ni sortie (-o)\n");
+        return -1;
+    }
+    if (config->outputPattern && config->inputCount > 1
+        && !strstr(config->outputPattern, "{name}") && !strstr(config->outputPattern, "{index}")) {
+        printf("Erreur : plusieurs entrees, le motif de sortie doit contenir {name} ou {index}\n");
+        return -1;
+    }
+    if (config->jobs < 1) config->jobs = 1;
+    if (config->readers < 1) config->readers = 1;
+    if (config->writers < 1) config->writers = 1;
+    if (config->queueDepth < 1) config->queueDepth = 1;
+    if (config->poolCache < 0) config->poolCache = 0;
+    return 0;
+}
+
+/*
+Libère les tableaux alloués par batch_parseArgs
+*/
+void batch_freeConfig(t_batch_config *config) {
+    for (int i = 0; i < config->inputCount; i++) {
+        free(config->inputs[i]);
+    }
+    free(config->inputs);
+    free(config->ops);
+    memset(config, 0, sizeof(*config));
+}
+
+/*
+Construit le chemin de sortie : {name} = nom du fichier sans dossier ni extension,
+{index} = numéro du fichier dans la liste
+- Retourne -1 si le résultat ne tient pas dans out
+*/
+int batch_outputName(const char *pattern, const char *input, int index, char *out, size_t outSize) {
+    const char *base = input;
+    for (const char *c = input; *c; c++) {
+        if (*c == '/' || *c == '\\') base = c + 1;
+    }
+    const char *dot = strrchr(base, '.');
+    size_t baseLength = dot ? (size_t)(dot - base) : strlen(base);
+
+    size_t length = 0;
+    for (const char *p = pattern; *p; ) {
+        char piece[32];
+        const char *text = p;
+        size_t n = 1;
+
+        if (strncmp(p, "{name}", 6) == 0) {
+            text = base;
+            n = baseLength;
+            p += 6;
+        } else if (strncmp(p, "{index}", 7) == 0) {
+            snprintf(piece, sizeof(piece), "%d", index);
+            text = piece;
+            n = strlen(piece);
+            p += 7;
+        } else {
+            p++;
+        }
+
+        if (length + n >= outSize) return -1;
+        memcpy(out + length, text, n);
+        length += n;
+    }
+    out[length] = '\0';
+    return 0;
+}
+
+// Retour de batch_readDepth quand le fichier ne peut pas être ouvert
+#define BATCH_OPEN_FAILED (-2)
+
+/*
+Lit la profondeur de couleur (bits par pixel) dans l'en-tête d'un fichier BMP
+- Retourne -1 si le fichier n'est pas un BMP, BATCH_OPEN_FAILED s'il ne peut pas être ouvert
+*/
+static int batch_readDepth(const char *filename) {
+    FILE *file = fopen(filename, "rb");
+    if (!file) return BATCH_OPEN_FAILED;
+
+    unsigned char header[30];
+    int depth = -1;
+    if (fread(header, 1, sizeof(header), file) == sizeof(header) && header[0] == 'B' && header[1] == 'M') {
+        depth = header[28] | (header[29] << 8);
+    }
+    fclose(file);
+    return depth;
+}
+
+/*
+Noyau associé à une opération de convolution (NULL sinon)
+- gaussian=R : noyau de rayon R (taille 2R + 1), box=R passe par bmp8/bmp24_boxBlurRadius
+- Sans valeur : noyaux 3x3 de filtres.c
+*/
+static t_kernel *batch_createKernel(const t_batch_op *op) {
+    if (op->type == OP_GAUSSIAN_BLUR && op->value > 0) return createGaussianKernel(op->value, 0.0f);
+
+    float **matrix;
+    switch (op->type) {
+        case OP_BOX_BLUR: matrix = createBoxBlurKernel(); break;
+        case OP_GAUSSIAN_BLUR: matrix = createGaussianBlurKernel(); break;
+        case OP_OUTLINE: matrix = createOutlineKernel(); break;
+        case OP_EMBOSS: matrix = createEmbossKernel(); break;
+        case OP_SHARPEN: matrix = createSharpenKernel(); break;
+        default: return NULL;
+    }
+    if (!matrix) return NULL;
+    t_kernel *kernel = createKernelFromMatrix(matrix, 3);
+    freeKernel(matrix);
+    return kernel;
+}
+
+// Opérations point à point 8 bits, regroupées dans une chaîne
+static int batch_isPointOp8(t_batch_opType type) {
+    return type == OP_NEGATIVE || type == OP_BRIGHTNESS || type == OP_THRESHOLD;
+}
+
+/*
+Applique les opérations de la configuration, dans l'ordre, à une image 8 bits
+- Les opérations point à point consécutives sont appliquées en une seule passe (bmp8_chainApply)
+- Retourne 0, ou -1 si une opération échoue (l'image ne doit pas être sauvegardée)
+*/
+static int batch_apply8(const t_batch_config *config, t_bmp8 *img, const char *input) {
+    t_bmp8_chain chain;
+    bmp8_chainInit(&chain);
+
+    int status = 0;
+    for (int i = 0; i < config->opCount && status == 0; i++) {
+        const t_batch_op *op = &config->ops[i];
+        if (!batch_isPointOp8(op->type) && chain.stepCount > 0) {
+            bmp8_chainApply(img, &chain);
+            bmp8_chainInit(&chain);
+        }
+
+        switch (op->type) {
+            case OP_INFO: bmp8_printInfo(img); break;
+            case OP_NEGATIVE: bmp8_chainNegative(&chain); break;
+            case OP_BRIGHTNESS: bmp8_chainBrightness(&chain, op->value); break;
+            case OP_THRESHOLD: bmp8_chainThreshold(&chain, op->value); break;
+            case OP_SOFT_BLUR:
+                if (bmp8_gaussianBlurSigma(img, (float)op->value) != 0) status = -1;
+                break;
+            case OP_CLAHE: bmp8_clahe(img, 0, 0, op->value > 0 ? (float)op->value : CLAHE_DEFAULT_CLIP); break;
+            case OP_EQUALIZE: {
+                unsigned int *hist = bmp8_computeHistogram(img);
+                unsigned int *cdf = bmp8_computeCDF(hist, img->dataSize);
+                bmp8_equalize(img, cdf);
+                free(hist);
+                free(cdf);
+                break;
+            }
+            case OP_GRAYSCALE:
+                printf("Erreur : grayscale ne s'applique qu'aux images 24 bits (%s)\n", input);
+                status = -1;
+                break;
+            case OP_BOX_BLUR:
+                if (op->value > 0) {
+                    bmp8_boxBlurRadius(img, op->value);
+                    break;
+                }
+                // fall through
+            default: {
+                t_kernel *kernel = batch_createKernel(op);
+                if (!kernel) {
+                    status = -1;
+                    break;
+                }
+                bmp8_applyKernel(img, kernel);
+                destroyKernel(kernel);
+                break;
+            }
+        }
+    }
+    if (status == 0 && chain.stepCount > 0) bmp8_chainApply(img, &chain);
+    return status;
+}
+
+/*
+Applique les opérations de la configuration, dans l'ordre, à une image 24 bits
+- Retourne 0, ou -1 si une opération échoue (l'image ne doit pas être sauvegardée)
+*/
+static int batch_apply24(const t_batch_config *config, t_bmp24 *img, const char *input) {
+    int status = 0;
+    for (int i = 0; i < config->opCount && status == 0; i++) {
+        const t_batch_op *op = &config->ops[i];
+        switch (op->type) {
+            case OP_INFO:
+                printf("%s : %d x %d, %d bits\n", input, img->width, img->height, img->colorDepth);
+                break;
+            case OP_NEGATIVE: bmp24_negative(img); break;
+            case OP_BRIGHTNESS: bmp24_brightness(img, op->value); break;
+            case OP_GRAYSCALE: bmp24_grayscale(img); break;
+            case OP_BOX_BLUR:
+                if (op->value > 0) {
+                    bmp24_boxBlurRadius(img, op->value);
+                    break;
+                }
+                // fall through
+            case OP_GAUSSIAN_BLUR:
+            case OP_OUTLINE:
+            case OP_EMBOSS:
+            case OP_SHARPEN: {
+                t_kernel *kernel = batch_createKernel(op);
+                if (!kernel) {
+                    status = -1;
+                    break;
+                }
+                bmp24_applyKernel(img, kernel);
+                destroyKernel(kernel);
+                break;
+            }
+            case OP_EQUALIZE: bmp24_equalize(img); break;
+            case OP_SOFT_BLUR:
+                if (bmp24_gaussianBlurSigma(img, (float)op->value) != 0) status = -1;
+                break;
+            case OP_CLAHE: bmp24_clahe(img, 0, 0, op->value > 0 ? (float)op->value : CLAHE_DEFAULT_CLIP); break;
+            case OP_THRESHOLD:
+                printf("Erreur : threshold ne s'applique qu'aux images 8 bits (%s)\n", input);
+                status = -1;
+                break;
+        }
+    }
+    return status;
+}
+
+/*
+Fichier en cours de traitement, passé d'une étape du pipeline à la suivante
+- Une seule des deux images est non NULL (selon depth)
+- status : 0, ou -1 si une opération (pas de sauvegarde) ou la sauvegarde a échoué
+*/
+typedef struct {
+    int index;
+    int depth;
+    t_bmp8 *img8;
+    t_bmp24 *img24;
+    int status;
+    char output[BATCH_PATH_MAX];
+} t_batch_item;
+
+/*
+File bornée entre deux étapes du pipeline (tableau circulaire sous verrou)
+- push bloque quand la file est pleine : une étape rapide ne peut pas prendre d'avance
+  de plus de capacity images sur la suivante, la mémoire utilisée reste bornée
+- producers : nombre d'étapes productrices encore actives ; quand il tombe à 0, la file est
+  fermée et pop retourne NULL une fois vide
+*/
+typedef struct {
+    t_batch_item **items;
+    int capacity;
+    int head;
+    int count;
+    int producers;
+    pthread_mutex_t lock;
+    pthread_cond_t notEmpty;
+    pthread_cond_t notFull;
+} t_batch_queue;
+
+static int batch_queueInit(t_batch_queue *queue, int capacity, int producers) {
+    queue->items = malloc(capacity * sizeof(t_batch_item *));
+    if (!queue->items) return -1;
+    queue->capacity = capacity;
+    queue->head = 0;
+    queue->count = 0;
+    queue->producers = producers;
+    pthread_mutex_init(&queue->lock, NULL);
+    pthread_cond_init(&queue->notEmpty, NULL);
+    pthread_cond_init(&queue->notFull, NULL);
+    return 0;
+}
+
+static void batch_queueDestroy(t_batch_queue *queue) {
+    free(queue->items);
+    pthread_mutex_destroy(&queue->lock);
+    pthread_cond_destroy(&queue->notEmpty);
+    pthread_cond_destroy(&queue->notFull);
+}
+
+static void batch_queuePush(t_batch_queue *queue, t_batch_item *item) {
+    pthread_mutex_lock(&queue->lock);
+    while (queue->count == queue->capacity) {
+        pthread_cond_wait(&queue->notFull, &queue->lock);
+    }
+    queue->items[(queue->head + queue->count) % queue->capacity] = item;
+    queue->count++;
+    pthread_cond_signal(&queue->notEmpty);
+    pthread_mutex_unlock(&queue->lock);
+}
+
+/*
+Retire le plus ancien fichier de la file (attend s'il n'y en a pas)
+- Retourne NULL quand la file est vide et fermée
+*/
+static t_batch_item *batch_queuePop(t_batch_queue *queue) {
+    pthread_mutex_lock(&queue->lock);
+    while (queue->count == 0 && queue->producers > 0) {
+        pthread_cond_wait(&queue->notEmpty, &queue->lock);
+    }
+    t_batch_item *item = NULL;
+    if (queue->count > 0) {
+        item = queue->items[queue->head];
+        queue->head = (queue->head + 1) % queue->capacity;
+        queue->count--;
+        pthread_cond_signal(&queue->notFull);
+    }
+    pthread_mutex_unlock(&queue->lock);
+    return item;
+}
+
+// Un producteur de la file a terminé : la file se ferme quand il n'en reste plus
+static void batch_queueDone(t_batch_queue *queue) {
+    pthread_mutex_lock(&queue->lock);
+    if (--queue->producers == 0) pthread_cond_broadcast(&queue->notEmpty);
+    pthread_mutex_unlock(&queue->lock);
+}
+
+/*
+État partagé par les étapes du pipeline
+- loaded : images chargées, en attente des filtres ; processed : images filtrées, à sauvegarder
+*/
+typedef struct {
+    const t_batch_config *config;
+    pthread_mutex_t lock;
+    int next;                   // prochain fichier à charger
+    int failures;
+    t_batch_queue loaded;
+    t_batch_queue processed;
+} t_batch_state;
+
+static void batch_addFailure(t_batch_state *state) {
+    pthread_mutex_lock(&state->lock);
+    state->failures++;
+    pthread_mutex_unlock(&state->lock);
+}
+
+static void batch_freeItem(t_batch_item *item) {
+    bmp8_free(item->img8);
+    bmp24_free(item->img24);
+    free(item);
+}
+
+/*
+Charge le fichier d'indice index : profondeur, nom de sortie, pixels
+- Retourne NULL (message affiché) si le fichier ne peut pas être traité
+*/
+static t_batch_item *batch_loadFile(const t_batch_config *config, int index) {
+    const char *input = config->inputs[index];
+    t_batch_item *item = calloc(1, sizeof(t_batch_item));
+    if (!item) return NULL;
+    item->index = index;
+
+    if (config->outputPattern
+        && batch_outputName(config->outputPattern, input, index, item->output, sizeof(item->output)) != 0) {
+        printf("Erreur : chemin de sortie trop long pour %s\n", input);
+        free(item);
+        return NULL;
+    }
+
+    item->depth = batch_readDepth(input);
+    if (item->depth == 8) {
+        item->img8 = config->mapped ? bmp8_loadImageMapped(input) : bmp8_loadImage(input);
+    } else if (item->depth == 24 || item->depth == 32) {
+        // 32 bits : pixels ramenés en BGR, alpha gardé et réécrit à la sauvegarde
+        item->img24 = config->mapped ? bmp24_loadImageMapped(input) : bmp24_loadImage(input);
+    } else if (item->depth == BATCH_OPEN_FAILED) {
+        printf("Erreur : impossible d'ouvrir %s\n", input);
+    } else {
+        printf("Erreur : %s n'est pas une image BMP 8, 24 ou 32 bits\n", input);
+    }
+    if (!item->img8 && !item->img24) {
+        free(item);
+        return NULL;
+    }
+    return item;
+}
+
+/*
+Étape 1 : charge les fichiers dans l'ordre de la liste et les passe aux filtres
+*/
+static void *batch_reader(void *arg) {
+    t_batch_state *state = arg;
+    for (;;) {
+        pthread_mutex_lock(&state->lock);
+        int index = state->next++;
+        pthread_mutex_unlock(&state->lock);
+        if (index >= state->config->inputCount) break;
+
+        t_batch_item *item = batch_loadFile(state->config, index);
+        if (item) {
+            batch_queuePush(&state->loaded, item);
+        } else {
+            batch_addFailure(state);
+        }
+    }
+    batch_queueDone(&state->loaded);
+    return NULL;
+}
+
+// Applique les opérations de la configuration à l'image du fichier
+static void batch_processItem(const t_batch_config *config, t_batch_item *item) {
+    const char *input = config->inputs[item->index];
+    item->status = item->img8 ? batch_apply8(config, item->img8, input)
+                              : batch_apply24(config, item->img24, input);
+}
+
+// Sauvegarde l'image filtrée (si demandé) et libère le fichier ; un échec d'écriture compte comme un échec
+static void batch_saveItem(t_batch_state *state, t_batch_item *item) {
+    if (item->status == 0 && state->config->outputPattern) {
+        item->status = item->img8 ? bmp8_saveImage(item->output, item->img8)
+                                  : bmp24_saveImage(item->img24, item->output);
+    }
+    if (item->status != 0) batch_addFailure(state);
+    batch_freeItem(item);
+}
+
+/*
+Étape 2 : applique les opérations aux images chargées
+- Les filtres d'un fichier utilisent le pool de threads s'il est libre
+*/
+static void *batch_worker(void *arg) {
+    t_batch_state *state = arg;
+    t_batch_item *item;
+    while ((item = batch_queuePop(&state->loaded)) != NULL) {
+        batch_processItem(state->config, item);
+        batch_queuePush(&state->processed, item);
+    }
+    batch_queueDone(&state->processed);
+    return NULL;
+}
+
+/*
+Étape 3 : sauvegarde les images filtrées et les libère
+*/
+static void *batch_writer(void *arg) {
+    t_batch_state *state = arg;
+    t_batch_item *item;
+    while ((item = batch_queuePop(&state->processed)) != NULL) {
+        batch_saveItem(state, item);
+    }
+    return NULL;
+}
+
+/*
+Traitement sans pipeline, fichier par fichier (si les threads des étapes ne peuvent être créés)
+*/
+static void batch_runSequential(t_batch_state *state) {
+    for (int index = 0; index < state->config->inputCount; index++) {
+        t_batch_item *item = batch_loadFile(state->config, index);
+        if (!item) {
+            batch_addFailure(state);
+            continue;
+        }
+        batch_processItem(state->config, item);
+        batch_saveItem(state, item);
+    }
+}
+
+/*
+Démarre count threads sur une étape du pipeline
+- Retourne le nombre de threads effectivement créés
+*/
+static int batch_startStage(pthread_t *threads, int count, void *(*stage)(void *), t_batch_state *state) {
+    int started = 0;
+    while (started < count && pthread_create(&threads[started], NULL, stage, state) == 0) {
+        started++;
+    }
+    return started;
+}
+
+/*
+Traite tous les fichiers en pipeline : chargement -> filtres -> sauvegarde
+- readers threads chargent les fichiers suivants pendant que jobs threads filtrent et que
+  writers threads écrivent les précédents : lectures, calculs et écritures se recouvrent,
+  le lot avance au rythme de l'étape la plus lente au lieu de la somme des trois
+- Files bornées à queueDepth images entre deux étapes (mémoire limitée)
+- Le thread principal est l'un des threads de filtrage
+*/
+int batch_run(const t_batch_config *config) {
+    t_batch_state state;
+    state.config = config;
+    state.next = 0;
+    state.failures = 0;
+
+    int count = config->inputCount;
+    int jobs = config->jobs < count ? config->jobs : count;
+    int readers = config->readers < count ? config->readers : count;
+    int writers = config->writers < count ? config->writers : count;
+    pthread_mutex_init(&state.lock, NULL);
+    pthread_t *threads = malloc((readers + writers + jobs) * sizeof(pthread_t));
+    if (!threads || batch_queueInit(&state.loaded, config->queueDepth, readers) != 0) {
+        free(threads);
+        threads = NULL;
+    } else if (batch_queueInit(&state.processed, config->queueDepth, jobs) != 0) {
+        batch_queueDestroy(&state.loaded);
+        free(threads);
+        threads = NULL;
+    }
+
+    // Écriture d'abord, lecture ensuite : chaque étape démarrée a toujours de quoi se vider
+    int started = threads ? batch_startStage(threads, writers, batch_writer, &state) : 0;
+    int readersStarted = 0;
+    if (started > 0) {
+        readersStarted = batch_startStage(threads + started, readers, batch_reader, &state);
+        started += readersStarted;
+    }
+    if (readersStarted == 0) {
+        // Pas de pipeline possible : ferme la file des écritures et traite les fichiers un par un
+        for (int i = 0; threads && started > 0 && i < jobs; i++) batch_queueDone(&state.processed);
+        batch_runSequential(&state);
+    } else {
+        for (int i = readersStarted; i < readers; i++) batch_queueDone(&state.loaded);
+        int workers = batch_startStage(threads + started, jobs - 1, batch_worker, &state);
+        started += workers;
+        for (int i = workers; i < jobs - 1; i++) batch_queueDone(&state.processed);
+        batch_worker(&state);  // le thread principal filtre aussi
+    }
+
+    for (int i = 0; i < started; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    if (threads) {
+        batch_queueDestroy(&state.loaded);
+        batch_queueDestroy(&state.processed);
+    }
+    free(threads);
+    pthread_mutex_destroy(&state.lock);
+
+    printf("%d fichier(s) traite(s), %d echec(s)\n", count - state.failures, state.failures);
+    return state.failures;
+}
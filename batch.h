@@ -0,0 +1,60 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+#include <stddef.h>
+#include "filtres.h"
+
+// Opérations disponibles en mode batch (dans l'ordre donné sur la ligne de commande)
+typedef enum {
+    OP_INFO,
+    OP_NEGATIVE,
+    OP_BRIGHTNESS,
+    OP_THRESHOLD,
+    OP_GRAYSCALE,
+    OP_BOX_BLUR,
+    OP_GAUSSIAN_BLUR,
+    OP_OUTLINE,
+    OP_EMBOSS,
+    OP_SHARPEN,
+    OP_EQUALIZE,
+    OP_SOFT_BLUR,
+    OP_CLAHE
+} t_batch_opType;
+
+typedef struct {
+    t_batch_opType type;
+    int value;                  // paramètre (luminosité, seuil)
+} t_batch_op;
+
+// Images en attente entre deux étapes du pipeline (chargement -> filtres -> sauvegarde)
+#define BATCH_DEFAULT_QUEUE_DEPTH 2
+
+// Configuration d'un traitement batch
+typedef struct {
+    char **inputs;              // fichiers d'entrée (motifs glob déjà développés)
+    int inputCount;
+    t_batch_op *ops;
+    int opCount;
+    const char *outputPattern;  // NULL : pas de sauvegarde
+    int jobs;                   // fichiers filtrés en parallèle
+    int readers;                // threads de chargement
+    int writers;                // threads de sauvegarde
+    int queueDepth;             // images en attente entre deux étapes
+    int threads;                // threads du pool des filtres (0 : automatique)
+    int mapped;                 // chargement par projection mémoire
+    t_border border;            // bords des filtres (BORDER_CLAMP par défaut)
+    int poolCache;              // cache du pool d'allocation en Mo (0 : allocateur système)
+} t_batch_config;
+
+// Analyse la ligne de commande : 0 si OK, -1 si erreur (message affiché)
+int batch_parseArgs(int argc, char **argv, t_batch_config *config);
+void batch_freeConfig(t_batch_config *config);
+void batch_usage(const char *program);
+
+// Traite tous les fichiers (pipeline chargement -> filtres -> sauvegarde) : retourne le nombre d'échecs
+int batch_run(const t_batch_config *config);
+
+// Construit le nom de sortie d'un fichier à partir du motif ({name}, {index})
+int batch_outputName(const char *pattern, const char *input, int index, char *out, size_t outSize);
+
+#endif
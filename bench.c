@@ -0,0 +1,681 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <fcntl.h>
+#include "bmp8.h"
+#include "bmp24.h"
+#include "filtres.h"
+#include "simd.h"
+#include "parallele.h"
+#include "memoire.h"
+
+#ifdef _WIN32
+#include <io.h>
+#include <windows.h>
+#define BENCH_NULL_DEVICE "NUL"
+#else
+#include <unistd.h>
+#include <time.h>
+#define BENCH_NULL_DEVICE "/dev/null"
+#endif
+
+/*
+Banc de mesure des traitements d'images
+- Génère des images synthétiques 8 et 24 bits de plusieurs tailles
+- Chronomètre chaque opération publique (chargement, sauvegarde, filtres, histogramme, égalisation)
+- Quelques exécutions de chauffe, puis N répétitions : moyenne et écart type en mégapixels/s
+- --simd et --threads permettent de comparer les chemins optimisés au chemin scalaire mono-thread
+- --csv produit une sortie facile à comparer d'une version à l'autre
+*/
+
+// Tailles prédéfinies (la largeur est un multiple de 4 : bmp8 ne gère pas le bourrage des lignes)
+static const struct {
+    const char *name;
+    int width;
+    int height;
+} bench_presets[] = {
+    {"small",   256,  256},
+    {"medium", 1024,  768},
+    {"large",  1920, 1080},
+    {"xlarge", 4096, 3072},
+    {"huge",   8192, 8192}
+};
+
+#define BENCH_PRESET_COUNT (int)(sizeof(bench_presets) / sizeof(bench_presets[0]))
+#define BENCH_DEFAULT_PRESETS 4   // small à xlarge (huge : à demander avec -s huge)
+#define BENCH_MAX_SIZES 16
+
+/*
+Pixels entrelacés d'une image de test pour le prototype de convolution 3x3 (voir op24_conv3x3)
+- step : octets par pixel (3 : BGR, format interne ; 4 : BGRX), stride : octets par ligne
+*/
+typedef struct {
+    const uint8_t *pixels;
+    size_t stride;
+    int step;
+} t_bench_layout;
+
+// Contexte partagé par les opérations mesurées
+typedef struct {
+    const char *file;       // image synthétique sur disque
+    const char *output;     // fichier de sortie (save, streamed)
+    const char *file32;     // même image en 32 bits (load32)
+    t_bmp8 *img8;           // image de travail (remise à l'état initial avant chaque mesure)
+    unsigned char *pristine8;
+    t_bmp24 *img24;
+    t_bmp24 *pristine24;
+    t_bmp24 *img32;         // copie 32 bits de img24 (save32)
+    t_bench_layout bgr;     // prototype de convolution 3x3 entrelacée : img24 tel quel (3 octets)
+    t_bench_layout bgrx;    // même image en BGRX (4 octets, lignes alignées sur 64 octets)
+    uint8_t *convOutput;    // sortie des deux prototypes (assez grande pour BGRX)
+    t_bmp8 *loaded8;        // résultat des mesures de chargement
+    t_bmp24 *loaded24;
+    t_kernel *kernel5;      // noyau gaussien 5x5 (chemin séparable)
+    t_kernel *kernel15;     // noyau gaussien 15x15 (rayon 7, séparable)
+} t_bench_ctx;
+
+typedef struct {
+    const char *name;
+    int depth;
+    void (*run)(t_bench_ctx *ctx);
+    int needsReset;         // l'opération modifie l'image de travail
+} t_bench_op;
+
+/*
+Horloge monotone en secondes
+*/
+static double bench_now(void) {
+#ifdef _WIN32
+    LARGE_INTEGER frequency, counter;
+    QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+    return (double)counter.QuadPart / (double)frequency.QuadPart;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+#endif
+}
+
+/*
+Redirige la sortie standard vers le périphérique nul pendant les mesures
+(les fonctions de traitement affichent un message à chaque appel)
+- Retourne le descripteur à restaurer avec bench_restoreOutput, -1 si impossible
+*/
+static int bench_muteOutput(void) {
+    fflush(stdout);
+    int saved = dup(fileno(stdout));
+    int nul = open(BENCH_NULL_DEVICE, O_WRONLY);
+    if (saved < 0 || nul < 0) {
+        if (saved >= 0) close(saved);
+        if (nul >= 0) close(nul);
+        return -1;
+    }
+    dup2(nul, fileno(stdout));
+    close(nul);
+    return saved;
+}
+
+static void bench_restoreOutput(int saved) {
+    if (saved < 0) return;
+    fflush(stdout);
+    dup2(saved, fileno(stdout));
+    close(saved);
+}
+
+// Écriture little-endian dans un en-tête brut
+static void bench_put16(unsigned char *p, unsigned int v) {
+    p[0] = v & 0xFF;
+    p[1] = (v >> 8) & 0xFF;
+}
+
+static void bench_put32(unsigned char *p, unsigned int v) {
+    bench_put16(p, v & 0xFFFF);
+    bench_put16(p + 2, v >> 16);
+}
+
+/*
+Contenu synthétique : dégradé + bruit pseudo-aléatoire (générateur congruentiel, reproductible)
+- Histogramme non dégénéré, contours variés pour les filtres
+*/
+static unsigned char bench_sample(unsigned int *seed, int x, int y, int channel) {
+    *seed = *seed * 1664525u + 1013904223u;
+    return (unsigned char)((x * (channel + 1) + y * (3 - channel) + (*seed >> 26)) & 0xFF);
+}
+
+/*
+Crée une image 8 bits synthétique et l'enregistre dans filename
+*/
+static t_bmp8 *bench_createImage8(int width, int height, const char *filename) {
+    t_bmp8 *img = memory_calloc(1, sizeof(t_bmp8));  // libérée par bmp8_free
+    if (!img) return NULL;
+
+    img->width = width;
+    img->height = height;
+    img->colorDepth = 8;
+    img->dataSize = (unsigned int)width * height;
+    img->data = memory_alloc(img->dataSize);
+    if (!img->data) {
+        memory_free(img);
+        return NULL;
+    }
+
+    unsigned char *h = img->header;
+    h[0] = 'B';
+    h[1] = 'M';
+    bench_put32(h + 2, 54 + 1024 + img->dataSize);
+    bench_put32(h + 10, 54 + 1024);
+    bench_put32(h + 14, 40);
+    bench_put32(h + 18, width);
+    bench_put32(h + 22, height);
+    bench_put16(h + 26, 1);
+    bench_put16(h + 28, 8);
+    bench_put32(h + 34, img->dataSize);
+    bench_put32(h + 46, 256);
+
+    // Palette en niveaux de gris
+    for (int i = 0; i < 256; i++) {
+        img->colorTable[4 * i] = img->colorTable[4 * i + 1] = img->colorTable[4 * i + 2] = (unsigned char)i;
+    }
+
+    unsigned int seed = 8;
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            img->data[(size_t)y * width + x] = bench_sample(&seed, x, y, 1);
+        }
+    }
+
+    bmp8_saveImage(filename, img);
+    return img;
+}
+
+/*
+Crée une image 24 bits synthétique et l'enregistre dans filename
+*/
+static t_bmp24 *bench_createImage24(int width, int height, const char *filename) {
+    t_bmp24 *img = bmp24_allocate(width, height, 24);
+    if (!img) return NULL;
+
+    int rowBytes = (width * 3 + 3) & ~3;
+    img->header.type = BMP_TYPE;
+    img->header.size = HEADER_SIZE + INFO_SIZE + (uint32_t)rowBytes * height;
+    img->header.reserved1 = 0;
+    img->header.reserved2 = 0;
+    img->header.offset = HEADER_SIZE + INFO_SIZE;
+    memset(&img->header_info, 0, sizeof(t_bmp_info));
+    img->header_info.size = INFO_SIZE;
+    img->header_info.width = width;
+    img->header_info.height = height;
+    img->header_info.planes = 1;
+    img->header_info.bits = 24;
+    img->header_info.imagesize = (uint32_t)rowBytes * height;
+
+    unsigned int seed = 24;
+    for (int y = 0; y < height; y++) {
+        t_pixel *row = bmp24_row(img, y);
+        for (int x = 0; x < width; x++) {
+            row[x].blue = bench_sample(&seed, x, y, 0);
+            row[x].green = bench_sample(&seed, x, y, 1);
+            row[x].red = bench_sample(&seed, x, y, 2);
+        }
+    }
+
+    bmp24_saveImage(img, filename);
+    return img;
+}
+
+/*
+Copie 32 bits (BGRA, alpha opaque) d'une image 24 bits, enregistrée dans filename
+*/
+static t_bmp24 *bench_createImage32(const t_bmp24 *source, const char *filename) {
+    if (!source) return NULL;
+    t_bmp24 *img = bmp24_allocate(source->width, source->height, 32);
+    if (!img) return NULL;
+    img->header = source->header;
+    img->header_info = source->header_info;
+    bmp24_copyPixels(img, source);
+    bmp24_saveImage(img, filename);
+    return img;
+}
+
+/*
+Copie BGRX (4e octet à 255) d'une image 24 bits, lignes alignées sur MEMORY_ALIGNMENT
+- Retourne les pixels (à libérer par memory_free), stride : octets par ligne
+*/
+static uint8_t *bench_createBgrx(const t_bmp24 *img, size_t *stride) {
+    *stride = ((size_t)img->width * 4 + MEMORY_ALIGNMENT - 1) & ~(size_t)(MEMORY_ALIGNMENT - 1);
+    uint8_t *pixels = memory_alloc(*stride * img->height);
+    if (!pixels) return NULL;
+    for (int y = 0; y < img->height; y++) {
+        simd_expand3to4((const uint8_t *)bmp24_row(img, y), NULL, pixels + (size_t)y * *stride, (size_t)img->width);
+    }
+    return pixels;
+}
+
+// Noyau gaussien 5x5 (binomial, séparable)
+static t_kernel *bench_createKernel5(void) {
+    static const float binomial[5] = {1, 4, 6, 4, 1};
+    float values[25];
+    for (int i = 0; i < 5; i++) {
+        for (int j = 0; j < 5; j++) {
+            values[i * 5 + j] = binomial[i] * binomial[j] / 256.0f;
+        }
+    }
+    return createKernel(5, values);
+}
+
+// Applique un noyau 3x3 de filtres.c sur l'image 8 bits
+static void bench_filter8(t_bench_ctx *ctx, float **(*create)()) {
+    float **kernel = create();
+    bmp8_applyFilter(ctx->img8, kernel, 3);
+    freeKernel(kernel);
+}
+
+// ---- Opérations 8 bits ----
+static void op8_load(t_bench_ctx *ctx) {
+    bmp8_free(ctx->loaded8);
+    ctx->loaded8 = bmp8_loadImage(ctx->file);
+}
+static void op8_loadMapped(t_bench_ctx *ctx) {
+    bmp8_free(ctx->loaded8);
+    ctx->loaded8 = bmp8_loadImageMapped(ctx->file);
+}
+static void op8_save(t_bench_ctx *ctx) { bmp8_saveImage(ctx->output, ctx->img8); }
+static void op8_negative(t_bench_ctx *ctx) { bmp8_negative(ctx->img8); }
+static void op8_brightness(t_bench_ctx *ctx) { bmp8_brightness(ctx->img8, 40); }
+static void op8_threshold(t_bench_ctx *ctx) { bmp8_threshold(ctx->img8, 128); }
+static void op8_chain(t_bench_ctx *ctx) {
+    t_bmp8_chain chain;
+    bmp8_chainInit(&chain);
+    bmp8_chainNegative(&chain);
+    bmp8_chainBrightness(&chain, 40);
+    bmp8_chainThreshold(&chain, 128);
+    bmp8_chainApply(ctx->img8, &chain);
+}
+static void op8_box(t_bench_ctx *ctx) { bench_filter8(ctx, createBoxBlurKernel); }
+static void op8_box50(t_bench_ctx *ctx) { bmp8_boxBlurRadius(ctx->img8, 50); }
+static void op8_gaussianIIR(t_bench_ctx *ctx) { bmp8_gaussianBlurSigma(ctx->img8, 20.0f); }
+static void op8_gaussian(t_bench_ctx *ctx) { bench_filter8(ctx, createGaussianBlurKernel); }
+static void op8_outline(t_bench_ctx *ctx) { bench_filter8(ctx, createOutlineKernel); }
+static void op8_emboss(t_bench_ctx *ctx) { bench_filter8(ctx, createEmbossKernel); }
+static void op8_sharpen(t_bench_ctx *ctx) { bench_filter8(ctx, createSharpenKernel); }
+static void op8_gaussian5(t_bench_ctx *ctx) { bmp8_applyKernel(ctx->img8, ctx->kernel5); }
+static void op8_gaussian15(t_bench_ctx *ctx) { bmp8_applyKernel(ctx->img8, ctx->kernel15); }
+static void op8_streamed(t_bench_ctx *ctx) {
+    bmp8_applyKernelStreamed(ctx->file, ctx->output, ctx->kernel5, BMP8_DEFAULT_BAND_HEIGHT);
+}
+static void op8_histogram(t_bench_ctx *ctx) { free(bmp8_computeHistogram(ctx->img8)); }
+static void op8_equalize(t_bench_ctx *ctx) {
+    unsigned int *hist = bmp8_computeHistogram(ctx->img8);
+    unsigned int *cdf = bmp8_computeCDF(hist, ctx->img8->dataSize);
+    bmp8_equalize(ctx->img8, cdf);
+    free(hist);
+    free(cdf);
+}
+static void op8_clahe(t_bench_ctx *ctx) { bmp8_clahe(ctx->img8, 0, 0, CLAHE_DEFAULT_CLIP); }
+
+// ---- Opérations 24 bits ----
+static void op24_load(t_bench_ctx *ctx) {
+    bmp24_free(ctx->loaded24);
+    ctx->loaded24 = bmp24_loadImage(ctx->file);
+}
+static void op24_loadMapped(t_bench_ctx *ctx) {
+    bmp24_free(ctx->loaded24);
+    ctx->loaded24 = bmp24_loadImageMapped(ctx->file);
+}
+static void op24_save(t_bench_ctx *ctx) { bmp24_saveImage(ctx->img24, ctx->output); }
+static void op24_load32(t_bench_ctx *ctx) {
+    bmp24_free(ctx->loaded24);
+    ctx->loaded24 = bmp24_loadImage(ctx->file32);
+}
+static void op24_save32(t_bench_ctx *ctx) { bmp24_saveImage(ctx->img32, ctx->output); }
+
+/*
+Prototype : flou gaussien 3x3 vectorisé directement sur les pixels entrelacés
+- simd_convolve3x3 avec step = 3 (BGR) ou 4 (BGRX), composante par composante, bords ignorés
+- conv3x3_bgr et conv3x3_bgrx font le même calcul sur la même image : seule la disposition
+  en mémoire change, leur écart est le gain d'un format interne BGRX pour ce filtre
+*/
+typedef struct {
+    const t_bench_layout *layout;
+    uint8_t *output;
+    int width;
+} t_bench_convTask;
+
+static void bench_convTask(void *arg, int start, int stop, int worker) {
+    static const int16_t gaussian[9] = {1, 2, 1, 2, 4, 2, 1, 2, 1};
+    const t_bench_convTask *t = arg;
+    const t_bench_layout *layout = t->layout;
+    size_t bytes = (size_t)(t->width - 2) * layout->step;
+    (void)worker;
+    for (int y = start + 1; y <= stop; y++) {
+        const uint8_t *row = layout->pixels + (size_t)y * layout->stride;
+        simd_convolve3x3(row - layout->stride, row, row + layout->stride,
+                         t->output + (size_t)y * layout->stride + layout->step, bytes, (size_t)layout->step,
+                         gaussian, 16);
+    }
+}
+
+static void bench_conv3x3(t_bench_ctx *ctx, const t_bench_layout *layout) {
+    t_bench_convTask task = {layout, ctx->convOutput, ctx->img24->width};
+    parallel_for(ctx->img24->height - 2, 16, bench_convTask, &task);
+}
+
+static void op24_conv3x3Bgr(t_bench_ctx *ctx) { bench_conv3x3(ctx, &ctx->bgr); }
+static void op24_conv3x3Bgrx(t_bench_ctx *ctx) { bench_conv3x3(ctx, &ctx->bgrx); }
+
+static void op24_negative(t_bench_ctx *ctx) { bmp24_negative(ctx->img24); }
+static void op24_brightness(t_bench_ctx *ctx) { bmp24_brightness(ctx->img24, 40); }
+static void op24_gamma(t_bench_ctx *ctx) { bmp24_gamma(ctx->img24, 2.2f); }
+static void op24_grayscale(t_bench_ctx *ctx) { bmp24_grayscale(ctx->img24); }
+static void op24_box(t_bench_ctx *ctx) { bmp24_boxBlur(ctx->img24); }
+static void op24_box50(t_bench_ctx *ctx) { bmp24_boxBlurRadius(ctx->img24, 50); }
+static void op24_gaussianIIR(t_bench_ctx *ctx) { bmp24_gaussianBlurSigma(ctx->img24, 20.0f); }
+static void op24_gaussian(t_bench_ctx *ctx) { bmp24_gaussianBlur(ctx->img24); }
+static void op24_outline(t_bench_ctx *ctx) { bmp24_outline(ctx->img24); }
+static void op24_emboss(t_bench_ctx *ctx) { bmp24_emboss(ctx->img24); }
+static void op24_sharpen(t_bench_ctx *ctx) { bmp24_sharpen(ctx->img24); }
+static void op24_gaussian5(t_bench_ctx *ctx) { bmp24_applyKernel(ctx->img24, ctx->kernel5); }
+static void op24_gaussian15(t_bench_ctx *ctx) { bmp24_applyKernel(ctx->img24, ctx->kernel15); }
+static void op24_streamed(t_bench_ctx *ctx) {
+    bmp24_applyKernelStreamed(ctx->file, ctx->output, ctx->kernel5, BMP24_DEFAULT_BAND_HEIGHT);
+}
+static void op24_histogram(t_bench_ctx *ctx) { free(bmp24_computeHistograms(ctx->img24)); }
+static void op24_lumaHistogram(t_bench_ctx *ctx) { free(bmp24_computeLumaHistogram(ctx->img24)); }
+static void op24_equalize(t_bench_ctx *ctx) { bmp24_equalize(ctx->img24); }
+static void op24_clahe(t_bench_ctx *ctx) { bmp24_clahe(ctx->img24, 0, 0, CLAHE_DEFAULT_CLIP); }
+static void op24_planar(t_bench_ctx *ctx) {
+    t_bmp24_planar *planar = bmp24_toPlanar(ctx->img24);
+    bmp24_fromPlanar(ctx->img24, planar);
+    bmp24_freePlanar(planar);
+}
+static void op24_planar5(t_bench_ctx *ctx) {
+    t_bmp24_planar *planar = bmp24_toPlanar(ctx->img24);
+    bmp24_planarApplyKernel(planar, ctx->kernel5);
+    bmp24_fromPlanar(ctx->img24, planar);
+    bmp24_freePlanar(planar);
+}
+
+static const t_bench_op bench_ops[] = {
+    {"load",        8, op8_load,        0},
+    {"load_mapped", 8, op8_loadMapped,  0},
+    {"save",        8, op8_save,        0},
+    {"negative",    8, op8_negative,    1},
+    {"brightness",  8, op8_brightness,  1},
+    {"threshold",   8, op8_threshold,   1},
+    {"chain3",      8, op8_chain,       1},
+    {"box",         8, op8_box,         1},
+    {"box_r50",     8, op8_box50,       1},
+    {"gaussian",    8, op8_gaussian,    1},
+    {"outline",     8, op8_outline,     1},
+    {"emboss",      8, op8_emboss,      1},
+    {"sharpen",     8, op8_sharpen,     1},
+    {"gaussian5x5", 8, op8_gaussian5,   1},
+    {"gaussian15x15", 8, op8_gaussian15, 1},
+    {"gaussian_s20", 8, op8_gaussianIIR, 1},
+    {"streamed5x5", 8, op8_streamed,    0},
+    {"histogram",   8, op8_histogram,   0},
+    {"equalize",    8, op8_equalize,    1},
+    {"clahe",       8, op8_clahe,       1},
+    {"load",        24, op24_load,       0},
+    {"load_mapped", 24, op24_loadMapped, 0},
+    {"save",        24, op24_save,       0},
+    {"load32",      24, op24_load32,     0},
+    {"save32",      24, op24_save32,     0},
+    {"negative",    24, op24_negative,   1},
+    {"brightness",  24, op24_brightness, 1},
+    {"gamma",       24, op24_gamma,      1},
+    {"grayscale",   24, op24_grayscale,  1},
+    {"box",         24, op24_box,        1},
+    {"box_r50",     24, op24_box50,      1},
+    {"gaussian",    24, op24_gaussian,   1},
+    {"outline",     24, op24_outline,    1},
+    {"emboss",      24, op24_emboss,     1},
+    {"sharpen",     24, op24_sharpen,    1},
+    {"gaussian5x5", 24, op24_gaussian5,  1},
+    {"gaussian15x15", 24, op24_gaussian15, 1},
+    {"gaussian_s20", 24, op24_gaussianIIR, 1},
+    {"streamed5x5", 24, op24_streamed,   0},
+    {"histogram",   24, op24_histogram,  0},
+    {"luma_histogram", 24, op24_lumaHistogram, 0},
+    {"equalize",    24, op24_equalize,   1},
+    {"clahe",       24, op24_clahe,      1},
+    {"planar",      24, op24_planar,     1},
+    {"planar5x5",   24, op24_planar5,    1},
+    {"conv3x3_bgr", 24, op24_conv3x3Bgr, 0},
+    {"conv3x3_bgrx", 24, op24_conv3x3Bgrx, 0}
+};
+
+#define BENCH_OP_COUNT (int)(sizeof(bench_ops) / sizeof(bench_ops[0]))
+
+// Remet l'image de travail dans son état initial (hors chronométrage)
+static void bench_reset(t_bench_ctx *ctx, int depth) {
+    if (depth == 8) {
+        memcpy(ctx->img8->data, ctx->pristine8, ctx->img8->dataSize);
+    } else {
+        bmp24_copyPixels(ctx->img24, ctx->pristine24);
+    }
+}
+
+/*
+Mesure une opération : warmup exécutions ignorées, puis repeat exécutions chronométrées
+- Affiche le temps moyen, le débit moyen en Mpx/s et son écart type, le meilleur débit
+*/
+static void bench_measure(const t_bench_op *op, t_bench_ctx *ctx, int width, int height,
+                          int warmup, int repeat, int csv) {
+    double megapixels = (double)width * height / 1e6;
+    double sumTime = 0, sumRate = 0, sumRate2 = 0, bestRate = 0;
+
+    int saved = bench_muteOutput();
+    for (int i = 0; i < warmup + repeat; i++) {
+        if (op->needsReset) bench_reset(ctx, op->depth);
+
+        double start = bench_now();
+        op->run(ctx);
+        double elapsed = bench_now() - start;
+
+        if (i < warmup) continue;
+        double rate = megapixels / (elapsed > 1e-9 ? elapsed : 1e-9);
+        sumTime += elapsed;
+        sumRate += rate;
+        sumRate2 += rate * rate;
+        if (rate > bestRate) bestRate = rate;
+    }
+    bench_restoreOutput(saved);
+
+    double meanTime = sumTime / repeat;
+    double meanRate = sumRate / repeat;
+    double variance = repeat > 1 ? (sumRate2 - repeat * meanRate * meanRate) / (repeat - 1) : 0;
+    double stddev = variance > 0 ? sqrt(variance) : 0;
+
+    if (csv) {
+        printf("%d,%s,%d,%d,%.4f,%.2f,%.2f,%.2f\n", op->depth, op->name, width, height,
+               meanTime * 1e3, meanRate, stddev, bestRate);
+    } else {
+        printf("  %2d bits  %-13s %9.3f ms  %9.2f Mpx/s  +/- %7.2f  (max %9.2f)\n", op->depth, op->name,
+               meanTime * 1e3, meanRate, stddev, bestRate);
+    }
+    fflush(stdout);
+}
+
+/*
+Mesure toutes les opérations sélectionnées pour une taille d'image
+*/
+static void bench_runSize(int width, int height, const char *dir, const char *filter,
+                          int warmup, int repeat, int csv) {
+    char file8[1024], file24[1024], file32[1024], output[1024];
+    snprintf(file8, sizeof(file8), "%s/bench_%dx%d_8.bmp", dir, width, height);
+    snprintf(file24, sizeof(file24), "%s/bench_%dx%d_24.bmp", dir, width, height);
+    snprintf(file32, sizeof(file32), "%s/bench_%dx%d_32.bmp", dir, width, height);
+    snprintf(output, sizeof(output), "%s/bench_%dx%d_out.bmp", dir, width, height);
+
+    t_bench_ctx ctx;
+    memset(&ctx, 0, sizeof(ctx));
+    ctx.output = output;
+    ctx.file32 = file32;
+    ctx.kernel5 = bench_createKernel5();
+    ctx.kernel15 = createGaussianKernel(7, 0.0f);
+
+    int saved = bench_muteOutput();
+    ctx.img8 = bench_createImage8(width, height, file8);
+    ctx.img24 = bench_createImage24(width, height, file24);
+    ctx.pristine24 = bmp24_allocate(width, height, 24);
+    ctx.img32 = bench_createImage32(ctx.img24, file32);
+    if (ctx.img24) {
+        ctx.bgr.pixels = (const uint8_t *)bmp24_row(ctx.img24, 0);
+        ctx.bgr.stride = (size_t)ctx.img24->stride;
+        ctx.bgr.step = 3;
+        ctx.bgrx.pixels = bench_createBgrx(ctx.img24, &ctx.bgrx.stride);
+        ctx.bgrx.step = 4;
+        ctx.convOutput = memory_alloc(ctx.bgrx.stride * height);
+    }
+    bench_restoreOutput(saved);
+
+    ctx.pristine8 = ctx.img8 ? malloc(ctx.img8->dataSize) : NULL;
+    if (!ctx.img8 || !ctx.img24 || !ctx.img32 || !ctx.bgrx.pixels || !ctx.convOutput || !ctx.pristine8 || !ctx.pristine24
+        || !ctx.kernel5 || !ctx.kernel15) {
+        printf("Erreur : echec allocation memoire pour %d x %d\n", width, height);
+    } else {
+        memcpy(ctx.pristine8, ctx.img8->data, ctx.img8->dataSize);
+        bmp24_copyPixels(ctx.pristine24, ctx.img24);
+
+        if (!csv) printf("\n%d x %d (%.2f Mpx)\n", width, height, (double)width * height / 1e6);
+        for (int i = 0; i < BENCH_OP_COUNT; i++) {
+            if (filter && !strstr(bench_ops[i].name, filter)) continue;
+            ctx.file = bench_ops[i].depth == 8 ? file8 : file24;
+            bench_measure(&bench_ops[i], &ctx, width, height, warmup, repeat, csv);
+        }
+    }
+
+    bmp8_free(ctx.img8);
+    bmp8_free(ctx.loaded8);
+    bmp24_free(ctx.img24);
+    bmp24_free(ctx.loaded24);
+    bmp24_free(ctx.pristine24);
+    bmp24_free(ctx.img32);
+    memory_free((void *)ctx.bgrx.pixels);
+    memory_free(ctx.convOutput);
+    free(ctx.pristine8);
+    destroyKernel(ctx.kernel5);
+    destroyKernel(ctx.kernel15);
+    remove(file8);
+    remove(file24);
+    remove(file32);
+    remove(output);
+}
+
+static void bench_usage(const char *program) {
+    printf("Utilisation : %s [options]\n", program);
+    printf("  -s, --size TAILLE    small, medium, large, xlarge, huge ou LxH (repetable)\n");
+    printf("  -r, --repeat N       repetitions mesurees (defaut 5)\n");
+    printf("  -w, --warmup N       executions de chauffe non mesurees (defaut 1)\n");
+    printf("  -f, --filter NOM     ne mesure que les operations dont le nom contient NOM\n");
+    printf("  -t, --threads N      threads du pool (defaut : nombre de processeurs)\n");
+    printf("      --simd NIVEAU    scalar, sse2 ou avx2 (defaut : meilleur disponible)\n");
+    printf("  -d, --dir DOSSIER    dossier des fichiers temporaires (defaut .)\n");
+    printf("      --pool MO        pool d'allocation avec MO Mo de cache (defaut 0 : allocateur systeme)\n");
+    printf("      --csv            sortie CSV (depth,op,width,height,ms,mpx_s,stddev,max)\n");
+}
+
+/*
+Analyse une taille : nom prédéfini ou LxH
+*/
+static int bench_parseSize(const char *text, int *width, int *height) {
+    for (int i = 0; i < BENCH_PRESET_COUNT; i++) {
+        if (strcmp(text, bench_presets[i].name) == 0) {
+            *width = bench_presets[i].width;
+            *height = bench_presets[i].height;
+            return 0;
+        }
+    }
+    if (sscanf(text, "%dx%d", width, height) != 2 || *width < 4 || *height < 3) {
+        printf("Erreur : taille invalide '%s'\n", text);
+        return -1;
+    }
+    *width = (*width + 3) & ~3;   // bmp8 : lignes sans bourrage
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    int widths[BENCH_MAX_SIZES], heights[BENCH_MAX_SIZES];
+    int sizeCount = 0;
+    int repeat = 5, warmup = 1, threads = 0, csv = 0;
+    int simdLevel = -1;
+    int poolCache = 0;
+    const char *filter = NULL;
+    const char *dir = ".";
+
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        int hasValue = i + 1 < argc;
+
+        if ((strcmp(arg, "-s") == 0 || strcmp(arg, "--size") == 0) && hasValue) {
+            if (sizeCount == BENCH_MAX_SIZES) continue;
+            if (bench_parseSize(argv[++i], &widths[sizeCount], &heights[sizeCount]) != 0) return 1;
+            sizeCount++;
+        } else if ((strcmp(arg, "-r") == 0 || strcmp(arg, "--repeat") == 0) && hasValue) {
+            repeat = atoi(argv[++i]);
+        } else if ((strcmp(arg, "-w") == 0 || strcmp(arg, "--warmup") == 0) && hasValue) {
+            warmup = atoi(argv[++i]);
+        } else if ((strcmp(arg, "-f") == 0 || strcmp(arg, "--filter") == 0) && hasValue) {
+            filter = argv[++i];
+        } else if ((strcmp(arg, "-t") == 0 || strcmp(arg, "--threads") == 0) && hasValue) {
+            threads = atoi(argv[++i]);
+        } else if ((strcmp(arg, "-d") == 0 || strcmp(arg, "--dir") == 0) && hasValue) {
+            dir = argv[++i];
+        } else if (strcmp(arg, "--simd") == 0 && hasValue) {
+            const char *name = argv[++i];
+            simdLevel = strcmp(name, "scalar") == 0 ? SIMD_SCALAR
+                      : strcmp(name, "sse2") == 0 ? SIMD_SSE2
+                      : strcmp(name, "avx2") == 0 ? SIMD_AVX2 : -1;
+            if (simdLevel < 0) {
+                printf("Erreur : niveau SIMD inconnu '%s'\n", name);
+                return 1;
+            }
+        } else if (strcmp(arg, "--pool") == 0 && hasValue) {
+            poolCache = atoi(argv[++i]);
+        } else if (strcmp(arg, "--csv") == 0) {
+            csv = 1;
+        } else {
+            bench_usage(argv[0]);
+            return strcmp(arg, "-h") == 0 || strcmp(arg, "--help") == 0 ? 0 : 1;
+        }
+    }
+
+    if (sizeCount == 0) {
+        for (int i = 0; i < BENCH_DEFAULT_PRESETS; i++) {
+            widths[sizeCount] = bench_presets[i].width;
+            heights[sizeCount] = bench_presets[i].height;
+            sizeCount++;
+        }
+    }
+    if (repeat < 1) repeat = 1;
+    if (warmup < 0) warmup = 0;
+
+    simd_init();
+    if (simdLevel >= 0) simd_setLevel((t_simd_level)simdLevel);
+    parallel_init(threads);
+    if (poolCache > 0) memory_usePool((size_t)poolCache << 20);
+
+    if (csv) {
+        printf("depth,op,width,height,ms,mpx_s,stddev,max\n");
+    } else {
+        printf("SIMD : %s, threads : %d, pool : %d Mo, chauffe : %d, repetitions : %d\n",
+               simd_levelName(simd_getLevel()), parallel_getThreadCount(), poolCache, warmup, repeat);
+    }
+
+    for (int i = 0; i < sizeCount; i++) {
+        bench_runSize(widths[i], heights[i], dir, filter, warmup, repeat, csv);
+    }
+
+    if (poolCache > 0 && !csv) {
+        t_memoryStats stats;
+        memory_getStats(&stats);
+        printf("Pool : %zu allocations, %zu reutilisees, cache max %.1f Mo\n",
+               stats.allocations, stats.reused, stats.peakCachedBytes / 1048576.0);
+    }
+    memory_usePool(0);
+    parallel_shutdown();
+    return 0;
+}
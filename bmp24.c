@@ -1,6 +1,12 @@
 #include "bmp24.h"
 #include <stdlib.h>
+#include <string.h>
+#include <math.h>
 #include "filtres.h"
+#include "mapping.h"
+#include "simd.h"
+#include "parallele.h"
+#include "memoire.h"
 
 /*
 Fonction utilitaire pour lire des données brutes depuis un fichier
@@ -12,44 +18,60 @@ void file_rawRead(uint32_t position, void *buffer, uint32_t size, size_t n, FILE
     fread(buffer, size, n, file);
 }
 
+/*
+Calcule le stride (en octets) d'une ligne de pixels
+- Arrondi au multiple de BMP24_ALIGNMENT pour que chaque ligne commence alignée
+*/
+int bmp24_computeStride(int width) {
+    int rowBytes = width * (int)sizeof(t_pixel);
+    return (rowBytes + BMP24_ALIGNMENT - 1) / BMP24_ALIGNMENT * BMP24_ALIGNMENT;
+}
+
 /*
 Alloue la mémoire pour une matrice de pixels
-- Crée un tableau 2D de t_pixel
-- Gère les erreurs d'allocation
+- Un seul buffer contigu et aligné pour toutes les lignes
+- Le tableau retourné contient les vues sur chaque ligne (data[y][x])
+- pixels[0] est le début du buffer contigu
 */
 t_pixel **bmp24_allocateDataPixels(int width, int height) {
-    t_pixel **pixels = malloc(height * sizeof(t_pixel *));
+    if (height <= 0) return NULL;
+
+    t_pixel **pixels = memory_alloc(height * sizeof(t_pixel *));
     if (!pixels) return NULL;
 
+    int stride = bmp24_computeStride(width);
+    uint8_t *buffer = memory_alloc((size_t)stride * height);
+    if (!buffer) {
+        memory_free(pixels);
+        return NULL;
+    }
+
     for (int i = 0; i < height; i++) {
-        pixels[i] = malloc(width * sizeof(t_pixel));
-        if (!pixels[i]) {
-            for (int j = 0; j < i; j++) free(pixels[j]);
-            free(pixels);
-            return NULL;
-        }
+        pixels[i] = (t_pixel *)(buffer + (size_t)i * stride);
     }
     return pixels;
 }
 
 /*
 Libère la mémoire d'une matrice de pixels
+- Le buffer contigu est libéré en une fois, puis le tableau des lignes
 */
 void bmp24_freeDataPixels(t_pixel **pixels, int height) {
     if (!pixels) return;
-    for (int i = 0; i < height; i++) {
-        free(pixels[i]);
+    if (height > 0) {
+        memory_free(pixels[0]);
     }
-    free(pixels);
+    memory_free(pixels);
 }
 
 /*
 Alloue une structure t_bmp24 complète
 - Initialise les dimensions et la profondeur de couleur
 - Alloue la matrice de pixels
+- colorDepth = 32 : alloue aussi le plan alpha, opaque (255)
 */
 t_bmp24 *bmp24_allocate(int width, int height, int colorDepth) {
-    t_bmp24 *img = malloc(sizeof(t_bmp24));
+    t_bmp24 *img = memory_alloc(sizeof(t_bmp24));
     if (!img) return NULL;
 
     img->width = width;
@@ -57,9 +79,24 @@ t_bmp24 *bmp24_allocate(int width, int height, int colorDepth) {
     img->colorDepth = colorDepth;
     img->data = bmp24_allocateDataPixels(width, height);
     if (!img->data) {
-        free(img);
+        memory_free(img);
         return NULL;
     }
+    img->pixels = img->data[0];
+    img->stride = bmp24_computeStride(width);
+    img->mapping = NULL;
+    img->mappingSize = 0;
+    img->scratch = NULL;
+    img->scratchSize = 0;
+    img->alpha = NULL;
+    if (colorDepth == 32) {
+        img->alpha = memory_alloc((size_t)width * height);
+        if (!img->alpha) {
+            bmp24_free(img);
+            return NULL;
+        }
+        memset(img->alpha, 255, (size_t)width * height);
+    }
     return img;
 }
 
@@ -68,14 +105,82 @@ Libère toute la mémoire d'une image BMP 24 bits
 */
 void bmp24_free(t_bmp24 *img) {
     if (!img) return;
-    bmp24_freeDataPixels(img->data, img->height);
-    free(img);
+    if (img->mapping) {
+        // Vue projetée : seules les vues sur les lignes ont été allouées
+        mapping_close(img->mapping, img->mappingSize);
+        memory_free(img->data);
+    } else {
+        bmp24_freeDataPixels(img->data, img->height);
+    }
+    bmp24_releaseScratch(img);
+    memory_free(img->alpha);
+    memory_free(img);
+}
+
+/*
+Libère le buffer de travail des filtres (il sera réalloué au prochain filtre)
+- Utile pour rendre la mémoire d'une image gardée longtemps sans nouveau traitement
+*/
+void bmp24_releaseScratch(t_bmp24 *img) {
+    if (img == NULL) return;
+    memory_free(img->scratch);
+    img->scratch = NULL;
+    img->scratchSize = 0;
+}
+
+/*
+Buffer de travail aligné d'au moins size octets, gardé par l'image entre deux filtres
+- Réutilisé s'il est assez grand, sinon remplacé (l'ancien contenu n'est pas conservé) :
+  une suite de filtres n'alloue qu'au premier, ou quand il lui faut plus de place
+*/
+static void *bmp24_scratch(t_bmp24 *img, size_t size) {
+    if (img->scratchSize < size) {
+        memory_free(img->scratch);
+        img->scratch = memory_alloc(size);
+        img->scratchSize = img->scratch ? size : 0;
+    }
+    return img->scratch;
+}
+
+/*
+Copie les pixels d'une image dans une autre de même taille
+- Copie d'un seul bloc si les deux buffers ont la même organisation
+- Sinon ligne par ligne (par exemple depuis ou vers une vue projetée)
+*/
+void bmp24_copyPixels(t_bmp24 *dst, const t_bmp24 *src) {
+    size_t rowBytes = (size_t)src->width * sizeof(t_pixel);
+    if (dst->stride == src->stride && dst->stride > 0) {
+        memcpy(dst->pixels, src->pixels, (size_t)src->stride * src->height);
+        return;
+    }
+    for (int y = 0; y < src->height; y++) {
+        memcpy(bmp24_row(dst, y), bmp24_row(src, y), rowBytes);
+    }
+}
+
+/*
+Vérifie que les pixels d'un fichier 32 bits sont au format BGRX / BGRA
+- Sans compression (BMP_BI_RGB) ou avec les masques standard (bleu, vert, rouge sur les octets 0, 1, 2)
+- Retourne 0 si le format est accepté, -1 sinon
+*/
+static int bmp24_check32(FILE *file) {
+    uint32_t compression = 0, masks[3] = {0, 0, 0};
+    fseek(file, BITMAP_COMPRESSION, SEEK_SET);
+    if (fread(&compression, sizeof(uint32_t), 1, file) != 1) return -1;
+    if (compression == BMP_BI_RGB) return 0;
+    if (compression != BMP_BI_BITFIELDS && compression != BMP_BI_ALPHABITFIELDS) return -1;
+
+    fseek(file, BITMAP_MASKS, SEEK_SET);
+    if (fread(masks, sizeof(uint32_t), 3, file) != 3) return -1;
+    return (masks[0] == 0x00FF0000u && masks[1] == 0x0000FF00u && masks[2] == 0x000000FFu) ? 0 : -1;
 }
 
 /*
-Charge une image BMP 24 bits depuis un fichier
-- Vérifie que la profondeur est bien 24 bits
+Charge une image BMP 24 ou 32 bits depuis un fichier
+- Vérifie que la profondeur est bien 24 ou 32 bits
 - Lit les en-têtes et les données
+- 32 bits : pixels ramenés en BGR, 4e octet dans img->alpha (voir bmp24_readPixelData)
+- Retourne NULL si le fichier est invalide ou tronqué (aucune image partiellement lue)
 */
 t_bmp24 *bmp24_loadImage(const char *filename) {
     FILE *file = fopen(filename, "rb");
@@ -93,8 +198,13 @@ t_bmp24 *bmp24_loadImage(const char *filename) {
     fseek(file, BITMAP_DEPTH, SEEK_SET);
     fread(&bits, sizeof(uint16_t), 1, file);
 
-    if (bits != 24) {
-        printf("Erreur : image non 24 bits (%d bits detectes)\n", bits);
+    if (bits != 24 && bits != 32) {
+        printf("Erreur : image non 24 ou 32 bits (%d bits detectes)\n", bits);
+        fclose(file);
+        return NULL;
+    }
+    if (bits == 32 && bmp24_check32(file) != 0) {
+        printf("Erreur : format de pixels 32 bits non supporte dans %s\n", filename);
         fclose(file);
         return NULL;
     }
@@ -110,18 +220,97 @@ t_bmp24 *bmp24_loadImage(const char *filename) {
     file_rawRead(BITMAP_MAGIC, &img->header, sizeof(t_bmp_header), 1, file);
     file_rawRead(HEADER_SIZE, &img->header_info, sizeof(t_bmp_info), 1, file);
 
-    // Lire les données (avec fonctions demandées)
-    bmp24_readPixelData(img, file);
+    // Lire les données (avec fonctions demandées) : image incomplète libérée
+    if (bmp24_readPixelData(img, file) != 0) {
+        printf("Erreur : lecture des pixels impossible dans %s\n", filename);
+        bmp24_free(img);
+        fclose(file);
+        return NULL;
+    }
     printf("Bits detectes : %d\n", bits);
 
     fclose(file);
     return img;
 }
 
+/*
+Charge une image BMP 24 bits par projection mémoire (sans copie des pixels)
+- Les lignes du fichier sont au format de t_pixel (BGR) : data[y] pointe directement
+  dans la projection, de bas en haut (stride négatif)
+- Seul le tableau des vues sur les lignes est alloué
+- Les modifications restent en mémoire (copie à l'écriture), le fichier n'est pas touché
+- Si la projection est impossible, se rabat sur bmp24_loadImage (de même pour les fichiers 32 bits,
+  dont les lignes doivent être converties)
+*/
+t_bmp24 *bmp24_loadImageMapped(const char *filename) {
+    size_t size = 0;
+    uint8_t *map = mapping_open(filename, &size);
+    if (!map) return bmp24_loadImage(filename);
+
+    if (size < HEADER_SIZE + INFO_SIZE) {
+        printf("Erreur : fichier %s trop petit\n", filename);
+        mapping_close(map, size);
+        return NULL;
+    }
+
+    t_bmp24 *img = memory_alloc(sizeof(t_bmp24));
+    if (!img) {
+        mapping_close(map, size);
+        return NULL;
+    }
+    memcpy(&img->header, map + BITMAP_MAGIC, sizeof(t_bmp_header));
+    memcpy(&img->header_info, map + HEADER_SIZE, sizeof(t_bmp_info));
+
+    img->width = img->header_info.width;
+    img->height = img->header_info.height;
+    img->colorDepth = img->header_info.bits;
+
+    if (img->colorDepth == 32) {
+        memory_free(img);
+        mapping_close(map, size);
+        return bmp24_loadImage(filename);
+    }
+    if (img->colorDepth != 24) {
+        printf("Erreur : image non 24 ou 32 bits (%d bits detectes)\n", img->colorDepth);
+        memory_free(img);
+        mapping_close(map, size);
+        return NULL;
+    }
+
+    size_t paddedBytes = ((size_t)img->width * sizeof(t_pixel) + 3) & ~(size_t)3;
+    if (img->width <= 0 || img->height <= 0 || img->header.offset > size
+        || (size - img->header.offset) / paddedBytes < (size_t)img->height) {
+        printf("Erreur : donnees pixels incompletes dans %s\n", filename);
+        memory_free(img);
+        mapping_close(map, size);
+        return NULL;
+    }
+
+    img->data = memory_alloc(img->height * sizeof(t_pixel *));
+    if (!img->data) {
+        memory_free(img);
+        mapping_close(map, size);
+        return NULL;
+    }
+
+    // Première ligne de l'image = dernière ligne du fichier
+    img->pixels = (t_pixel *)(map + img->header.offset + (size_t)(img->height - 1) * paddedBytes);
+    img->stride = -(int)paddedBytes;
+    for (int y = 0; y < img->height; y++) {
+        img->data[y] = bmp24_row(img, y);
+    }
+    img->mapping = map;
+    img->mappingSize = size;
+    img->scratch = NULL;
+    img->scratchSize = 0;
+    img->alpha = NULL;
+    return img;
+}
+
 /*
 Lit la valeur d'un pixel spécifique depuis un fichier
 - Lit les 3 composantes BGR
-- Stocke dans la structure t_pixel (RGB)
+- Stocke dans la structure t_pixel
 */
 void bmp24_readPixelValue(t_bmp24 *image, int x, int y, FILE *file) {
     uint8_t bgr[3];
@@ -133,24 +322,50 @@ void bmp24_readPixelValue(t_bmp24 *image, int x, int y, FILE *file) {
 
 /*
 Lit toutes les données pixels d'une image BMP 24 bits
-- Gère le padding des lignes (multiple de 4 octets)
+- Une seule lecture par ligne, padding compris, directement dans la ligne
+  (t_pixel est au format BGR du fichier et le stride laisse la place du padding)
 - Lit de bas en haut (format BMP)
+- 32 bits : chaque ligne BGRX / BGRA est lue dans un buffer puis ramenée en BGR
+  (simd_compact4to3), le 4e octet allant dans image->alpha
+- Retourne 0 en cas de succès, -1 si le fichier est tronqué ou en cas d'échec d'allocation
 */
-void bmp24_readPixelData(t_bmp24 *image, FILE *file) {
-    int padding = (4 - (image->width * 3) % 4) % 4;
-
-    fseek(file, image->header.offset, SEEK_SET);
+int bmp24_readPixelData(t_bmp24 *image, FILE *file) {
+    size_t rowBytes = (size_t)image->width * sizeof(t_pixel);
+    size_t paddedBytes = (rowBytes + 3) & ~(size_t)3;
+
+    if (fseek(file, image->header.offset, SEEK_SET) != 0) return -1;
+    if (image->colorDepth == 32) {
+        size_t fileBytes = (size_t)image->width * 4;
+        uint8_t *line = memory_alloc(fileBytes);
+        if (!line) {
+            printf("Erreur d'allocation mémoire pour la lecture des pixels.\n");
+            return -1;
+        }
+        int status = 0;
+        for (int y = image->height - 1; y >= 0; y--) {
+            if (fread(line, 1, fileBytes, file) < fileBytes) {
+                printf("Erreur : donnees pixels incompletes\n");
+                status = -1;
+                break;
+            }
+            simd_compact4to3(line, (uint8_t *)bmp24_row(image, y),
+                             image->alpha ? image->alpha + (size_t)y * image->width : NULL, (size_t)image->width);
+        }
+        memory_free(line);
+        return status;
+    }
     for (int y = image->height - 1; y >= 0; y--) {
-        for (int x = 0; x < image->width; x++) {
-            bmp24_readPixelValue(image, x, y, file);
+        if (fread(bmp24_row(image, y), 1, paddedBytes, file) < rowBytes) {
+            printf("Erreur : donnees pixels incompletes\n");
+            return -1;
         }
-        fseek(file, padding, SEEK_CUR);  // sauter les octets de padding à chaque ligne
     }
+    return 0;
 }
 
 /*
 Écrit la valeur d'un pixel spécifique dans un fichier
-- Convertit de RGB à BGR (format BMP)
+- Écrit les composantes dans l'ordre BGR (format BMP)
 */
 void bmp24_writePixelValue(t_bmp24 *image, int x, int y, FILE *file) {
     uint8_t bgr[3];
@@ -162,64 +377,113 @@ void bmp24_writePixelValue(t_bmp24 *image, int x, int y, FILE *file) {
 
 /*
 Écrit toutes les données pixels d'une image BMP 24 bits
-- Ajoute le padding nécessaire pour les lignes
+- Une seule écriture par ligne, suivie du padding nécessaire
 - Écrit de bas en haut (format BMP)
+- 32 bits : chaque ligne est étalée en BGRA (simd_expand3to4, alpha de l'image ou 255)
+- Retourne 0, ou -1 si une écriture échoue
 */
-void bmp24_writePixelData(t_bmp24 *image, FILE *file) {
-    int padding = (4 - (image->width * 3) % 4) % 4;
+int bmp24_writePixelData(t_bmp24 *image, FILE *file) {
+    size_t rowBytes = (size_t)image->width * sizeof(t_pixel);
+    size_t padding = ((rowBytes + 3) & ~(size_t)3) - rowBytes;
     uint8_t pad[3] = {0, 0, 0};
 
-    fseek(file, image->header.offset, SEEK_SET);
+    if (fseek(file, image->header.offset, SEEK_SET) != 0) return -1;
+    if (image->colorDepth == 32) {
+        size_t fileBytes = (size_t)image->width * 4;
+        uint8_t *line = memory_alloc(fileBytes);
+        if (!line) return -1;
+        int status = 0;
+        for (int y = image->height - 1; y >= 0 && status == 0; y--) {
+            simd_expand3to4((const uint8_t *)bmp24_row(image, y),
+                            image->alpha ? image->alpha + (size_t)y * image->width : NULL, line, (size_t)image->width);
+            if (fwrite(line, 1, fileBytes, file) != fileBytes) status = -1;
+        }
+        memory_free(line);
+        return status;
+    }
 
     for (int y = image->height - 1; y >= 0; y--) {
-        for (int x = 0; x < image->width; x++) {
-            bmp24_writePixelValue(image, x, y, file);
-        }
-        fwrite(pad, 1, padding, file);  // écrire les octets de padding à la fin de chaque ligne
+        if (fwrite(bmp24_row(image, y), 1, rowBytes, file) != rowBytes) return -1;
+        if (padding && fwrite(pad, 1, padding, file) != padding) return -1;  // octets de padding en fin de ligne
     }
+    return 0;
 }
 
 /*
 Fonction utilitaire pour écrire des données brutes dans un fichier
+- Retourne 0, ou -1 si l'écriture échoue
 */
-void file_rawWrite(uint32_t position, void *buffer, uint32_t size, size_t n, FILE *file) {
-    fseek(file, position, SEEK_SET);
-    fwrite(buffer, size, n, file);
+int file_rawWrite(uint32_t position, void *buffer, uint32_t size, size_t n, FILE *file) {
+    if (fseek(file, position, SEEK_SET) != 0) return -1;
+    return fwrite(buffer, size, n, file) == n ? 0 : -1;
+}
+
+/*
+En-têtes d'une image 32 bits écrite en BGRA sans compression
+- En-tête d'informations de 40 octets et pixels juste après : les masques ou en-têtes étendus
+  (V4, V5) du fichier d'origine ne sont pas réécrits
+*/
+static void bmp24_headers32(const t_bmp24 *img, t_bmp_header *header, t_bmp_info *info) {
+    *header = img->header;
+    *info = img->header_info;
+    info->size = INFO_SIZE;
+    info->bits = 32;
+    info->compression = BMP_BI_RGB;
+    info->imagesize = (uint32_t)img->width * img->height * 4;
+    header->offset = HEADER_SIZE + INFO_SIZE;
+    header->size = header->offset + info->imagesize;
 }
 
 /*
 Sauvegarde une image BMP 24 bits dans un fichier
 - Écrit les en-têtes puis les données pixels
+- colorDepth = 32 : fichier 32 bits BGRA (voir bmp24_writePixelData)
+- Retourne 0, ou -1 si le fichier n'a pas pu être ouvert, écrit ou fermé
 */
-void bmp24_saveImage(t_bmp24 *img, const char *filename) {
+int bmp24_saveImage(t_bmp24 *img, const char *filename) {
     FILE *file = fopen(filename, "wb");
     if (!file) {
         printf("Erreur : impossible d'ouvrir le fichier %s en ecriture\n", filename);
-        return;
+        return -1;
     }
 
     // Écriture des en-têtes BMP
-    file_rawWrite(BITMAP_MAGIC, &img->header, sizeof(t_bmp_header), 1, file);
-    file_rawWrite(HEADER_SIZE, &img->header_info, sizeof(t_bmp_info), 1, file);
+    t_bmp24 image = *img;
+    if (img->colorDepth == 32) bmp24_headers32(img, &image.header, &image.header_info);
+    int status = file_rawWrite(BITMAP_MAGIC, &image.header, sizeof(t_bmp_header), 1, file);
+    if (status == 0) status = file_rawWrite(HEADER_SIZE, &image.header_info, sizeof(t_bmp_info), 1, file);
 
     // Écriture des données de pixels
-    bmp24_writePixelData(img, file);
+    if (status == 0) status = bmp24_writePixelData(&image, file);
 
-    fclose(file);
+    // fclose vide le tampon : une erreur d'écriture (disque plein) peut n'apparaître qu'ici
+    if (fclose(file) != 0) status = -1;
+    if (status != 0) {
+        printf("Erreur lors de l'ecriture de %s\n", filename);
+        return -1;
+    }
     printf("Image sauvegardee dans %s\n", filename);
+    return 0;
 }
 
 /*
-Applique un effet négatif à une image couleur
-- Inverse chaque composante RGB (255 - valeur)
+Contexte des traitements point à point (une tuile = un groupe de lignes)
 */
-void bmp24_negative(t_bmp24 *img) {
-    for (int y = 0; y < img->height; y++) {
-        for (int x = 0; x < img->width; x++) {
-            img->data[y][x].red   = 255 - img->data[y][x].red;
-            img->data[y][x].green = 255 - img->data[y][x].green;
-            img->data[y][x].blue  = 255 - img->data[y][x].blue;
-        }
+typedef struct {
+    t_bmp24 *img;
+    int value;
+} t_bmp24_pointTask;
+
+// Nombre minimal de lignes par tuile pour les traitements point à point (~64 Ko)
+static int bmp24_pointGrain(const t_bmp24 *img) {
+    return 65536 / (img->width * (int)sizeof(t_pixel) + 1) + 1;
+}
+
+static void bmp24_grayscaleTask(void *arg, int start, int stop, int worker) {
+    t_bmp24_pointTask *t = arg;
+    (void)worker;
+    for (int y = start; y < stop; y++) {
+        simd_grayscale3((uint8_t *)bmp24_row(t->img, y), (size_t)t->img->width);
     }
 }
 
@@ -228,39 +492,205 @@ Convertit une image couleur en niveaux de gris
 - Moyenne des 3 composantes RGB pour chaque pixel
 */
 void bmp24_grayscale(t_bmp24 *img) {
-    for (int y = 0; y < img->height; y++) {
-        for (int x = 0; x < img->width; x++) {
-            uint8_t r = img->data[y][x].red;
-            uint8_t g = img->data[y][x].green;
-            uint8_t b = img->data[y][x].blue;
-            uint8_t gray = (r + g + b) / 3;
-            img->data[y][x].red = img->data[y][x].green = img->data[y][x].blue = gray;
+    t_bmp24_pointTask task = {img, 0};
+    parallel_for(img->height, bmp24_pointGrain(img), bmp24_grayscaleTask, &task);
+}
+
+/*
+Initialise les trois tables à l'identité
+*/
+void bmp24_lutInit(t_bmp24_lut *lut) {
+    for (int i = 0; i < 256; i++) {
+        lut->blue[i] = lut->green[i] = lut->red[i] = (uint8_t)i;
+    }
+}
+
+// Borne une valeur dans [0, 255]
+static uint8_t bmp24_clamp(int v) {
+    return (uint8_t)(v < 0 ? 0 : (v > 255 ? 255 : v));
+}
+
+/*
+Compose une courbe avec les tables des canaux choisis : table[i] = curve[table[i]]
+- channels : combinaison de BMP24_CHANNEL_BLUE, BMP24_CHANNEL_GREEN, BMP24_CHANNEL_RED
+*/
+void bmp24_lutCurve(t_bmp24_lut *lut, int channels, const uint8_t curve[256]) {
+    for (int i = 0; i < 256; i++) {
+        if (channels & BMP24_CHANNEL_BLUE) lut->blue[i] = curve[lut->blue[i]];
+        if (channels & BMP24_CHANNEL_GREEN) lut->green[i] = curve[lut->green[i]];
+        if (channels & BMP24_CHANNEL_RED) lut->red[i] = curve[lut->red[i]];
+    }
+}
+
+// Négatif : 255 - valeur
+void bmp24_lutNegative(t_bmp24_lut *lut) {
+    uint8_t curve[256];
+    for (int i = 0; i < 256; i++) {
+        curve[i] = (uint8_t)(255 - i);
+    }
+    bmp24_lutCurve(lut, BMP24_CHANNEL_ALL, curve);
+}
+
+// Luminosité : valeur + value, bornée à [0, 255]
+void bmp24_lutBrightness(t_bmp24_lut *lut, int value) {
+    uint8_t curve[256];
+    for (int i = 0; i < 256; i++) {
+        curve[i] = bmp24_clamp(i + value);
+    }
+    bmp24_lutCurve(lut, BMP24_CHANNEL_ALL, curve);
+}
+
+/*
+Correction gamma : 255 * (valeur / 255)^(1 / gamma)
+- gamma > 1 éclaircit les tons moyens, gamma < 1 les assombrit
+*/
+void bmp24_lutGamma(t_bmp24_lut *lut, float gamma) {
+    bmp24_lutLevels(lut, 0, 255, gamma, 0, 255);
+}
+
+/*
+Niveaux : [inBlack, inWhite] est étiré sur [outBlack, outWhite], avec une correction gamma
+- Les valeurs hors de [inBlack, inWhite] sont ramenées aux bornes
+*/
+void bmp24_lutLevels(t_bmp24_lut *lut, int inBlack, int inWhite, float gamma, int outBlack, int outWhite) {
+    if (inWhite <= inBlack) inWhite = inBlack + 1;
+    if (gamma <= 0.0f) gamma = 1.0f;
+
+    uint8_t curve[256];
+    for (int i = 0; i < 256; i++) {
+        double t = (double)(i - inBlack) / (inWhite - inBlack);
+        t = t < 0.0 ? 0.0 : (t > 1.0 ? 1.0 : t);
+        t = pow(t, 1.0 / gamma);
+        curve[i] = bmp24_clamp((int)(outBlack + t * (outWhite - outBlack) + 0.5));
+    }
+    bmp24_lutCurve(lut, BMP24_CHANNEL_ALL, curve);
+}
+
+/*
+Reconnaît une table de la forme min(max(sign * i + offset, 0), 255) avec sign = +1 ou -1,
+identique sur les trois canaux (négatif, luminosité et leurs compositions)
+- offset est déduit des extrémités de la table, puis toute la table est vérifiée
+- Retourne 1 si c'est le cas
+*/
+static int bmp24_lutIsOffset(const t_bmp24_lut *lut, int *sign, int *offset) {
+    if (memcmp(lut->blue, lut->green, 256) != 0 || memcmp(lut->blue, lut->red, 256) != 0) return 0;
+    const uint8_t *t = lut->blue;
+
+    for (int s = 1; s >= -1; s -= 2) {
+        int low = s > 0 ? t[0] : t[255];      // valeur pour sign * i = 0
+        int high = s > 0 ? t[255] : t[0];     // valeur pour sign * i = 255
+        int b = low > 0 ? low : (high < 255 ? high - 255 : 0);
+
+        int match = 1;
+        for (int i = 0; i < 256 && match; i++) {
+            match = t[i] == bmp24_clamp(s > 0 ? i + b : 255 - i + b);
+        }
+        if (match) {
+            *sign = s;
+            *offset = b;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/*
+Contexte d'application des tables
+- sign != 0 : table reconnue, appliquée avec les noyaux SSE2/AVX2 (négatif puis addition saturée)
+- sign == 0 : une lecture de table par composante
+*/
+typedef struct {
+    t_bmp24 *img;
+    const t_bmp24_lut *lut;
+    int sign;
+    int offset;
+} t_bmp24_lutTask;
+
+static void bmp24_lutTask(void *arg, int start, int stop, int worker) {
+    t_bmp24_lutTask *t = arg;
+    const t_bmp24_lut *lut = t->lut;
+    size_t rowBytes = (size_t)t->img->width * sizeof(t_pixel);
+    (void)worker;
+
+    for (int y = start; y < stop; y++) {
+        t_pixel *row = bmp24_row(t->img, y);
+        if (t->sign != 0) {
+            // 255 - i est dans [0, 255] : l'addition saturée qui suit donne bien le clamp de 255 - i + offset
+            if (t->sign < 0) simd_negate((uint8_t *)row, rowBytes);
+            if (t->offset != 0) simd_addSaturate((uint8_t *)row, rowBytes, t->offset);
+            continue;
         }
+        for (int x = 0; x < t->img->width; x++) {
+            row[x].blue = lut->blue[row[x].blue];
+            row[x].green = lut->green[row[x].green];
+            row[x].red = lut->red[row[x].red];
+        }
+    }
+}
+
+/*
+Applique les trois tables à l'image (une table par composante)
+- Tables de type négatif / luminosité : traitement vectoriel sans lecture de table
+- Autres tables (gamma, niveaux, courbes) : une lecture par composante
+- Lignes réparties sur le pool de threads
+*/
+void bmp24_applyLut(t_bmp24 *img, const t_bmp24_lut *lut) {
+    t_bmp24_lutTask task = {img, lut, 0, 0};
+    if (bmp24_lutIsOffset(lut, &task.sign, &task.offset) && task.sign > 0 && task.offset == 0) {
+        return;  // identité
     }
+    parallel_for(img->height, bmp24_pointGrain(img), bmp24_lutTask, &task);
+}
+
+/*
+Applique un effet négatif à une image couleur
+- Inverse chaque composante RGB (255 - valeur)
+- Passe par les tables : reconnue comme négatif, traitée en SSE2/AVX2
+*/
+void bmp24_negative(t_bmp24 *img) {
+    t_bmp24_lut lut;
+    bmp24_lutInit(&lut);
+    bmp24_lutNegative(&lut);
+    bmp24_applyLut(img, &lut);
 }
 
 /*
 Ajuste la luminosité d'une image couleur
 - Ajoute une valeur à chaque composante RGB
-- Clampe les valeurs entre 0 et 255
+- Clampe les valeurs entre 0 et 255 (addition saturée)
 */
 void bmp24_brightness(t_bmp24 *img, int value) {
-    for (int y = 0; y < img->height; y++) {
-        for (int x = 0; x < img->width; x++) {
-            int r = img->data[y][x].red + value;
-            int g = img->data[y][x].green + value;
-            int b = img->data[y][x].blue + value;
-            img->data[y][x].red   = (r > 255) ? 255 : (r < 0 ? 0 : r);
-            img->data[y][x].green = (g > 255) ? 255 : (g < 0 ? 0 : g);
-            img->data[y][x].blue  = (b > 255) ? 255 : (b < 0 ? 0 : b);
-        }
-    }
+    t_bmp24_lut lut;
+    bmp24_lutInit(&lut);
+    bmp24_lutBrightness(&lut, value);
+    bmp24_applyLut(img, &lut);
+}
+
+/*
+Correction gamma d'une image couleur (voir bmp24_lutGamma)
+*/
+void bmp24_gamma(t_bmp24 *img, float gamma) {
+    t_bmp24_lut lut;
+    bmp24_lutInit(&lut);
+    bmp24_lutGamma(&lut, gamma);
+    bmp24_applyLut(img, &lut);
+}
+
+/*
+Ajustement des niveaux d'une image couleur (voir bmp24_lutLevels)
+*/
+void bmp24_levels(t_bmp24 *img, int inBlack, int inWhite, float gamma, int outBlack, int outWhite) {
+    t_bmp24_lut lut;
+    bmp24_lutInit(&lut);
+    bmp24_lutLevels(&lut, inBlack, inWhite, gamma, outBlack, outWhite);
+    bmp24_applyLut(img, &lut);
 }
 
 /*
 Applique une convolution à un pixel spécifique
 - Utilise un noyau de convolution donné
-- Gère les bords de l'image
+- Référence pixel par pixel : les voisins hors de l'image sont ignorés (équivaut à
+  BORDER_CONSTANT de niveau 0) ; les filtres d'image passent par une copie agrandie (voir borderSet)
 */
 t_pixel bmp24_convolution(t_bmp24 *img, int x, int y, float **kernel, int kernelSize) {
     int offset = kernelSize / 2;
@@ -288,116 +718,582 @@ t_pixel bmp24_convolution(t_bmp24 *img, int x, int y, float **kernel, int kernel
 }
 
 /*
-Applique un filtre box blur à l'image
-- Crée un noyau de flou moyen
-- Applique la convolution à toute l'image
+Convolution entière d'un pixel : même calcul que bmp24_convolution, sans flottants
+- weights / divider : forme exacte du noyau (voir kernelToInteger)
+- Sommes exactes sur 32 bits, puis division arrondie par multiplication et décalage
 */
-void bmp24_boxBlur(t_bmp24 *img) {
-    float **kernel = createBoxBlurKernel();
-    t_bmp24 *tmp = bmp24_allocate(img->width, img->height, img->colorDepth);
-    if (!tmp) return;
+t_pixel bmp24_convolutionInt(t_bmp24 *img, int x, int y, const int32_t *weights, int kernelSize,
+                             const t_kernelDivider *divider) {
+    int offset = kernelSize / 2;
+    int32_t r = 0, g = 0, b = 0;
 
-    for (int y = 0; y < img->height; y++) {
-        for (int x = 0; x < img->width; x++) {
-            tmp->data[y][x] = bmp24_convolution(img, x, y, kernel, 3);
+    for (int i = -offset; i <= offset; i++) {
+        int yi = y + i;
+        if (yi < 0 || yi >= img->height) continue;
+        const t_pixel *src = bmp24_row(img, yi);
+        const int32_t *w = weights + (i + offset) * kernelSize + offset;
+        for (int j = -offset; j <= offset; j++) {
+            int xi = x + j;
+            if (xi >= 0 && xi < img->width) {
+                r += src[xi].red   * w[j];
+                g += src[xi].green * w[j];
+                b += src[xi].blue  * w[j];
+            }
         }
     }
 
-    // recopier dans l'image originale
-    for (int y = 0; y < img->height; y++) {
-        for (int x = 0; x < img->width; x++) {
-            img->data[y][x] = tmp->data[y][x];
-        }
+    t_pixel result;
+    result.red   = kernelDivide(divider, r);
+    result.green = kernelDivide(divider, g);
+    result.blue  = kernelDivide(divider, b);
+    return result;
+}
+
+// Nombre minimal de lignes par tuile pour les convolutions
+#define BMP24_FILTER_GRAIN 8
+
+/*
+Copie agrandie d'une image : radius pixels de halo de chaque côté (voir bmp24_padImage)
+- origin : pixel (0, 0) de l'image dans le buffer, stride : écart en octets entre deux lignes
+- extra : zone de travail demandée en plus (buffers par thread), à la suite de la copie
+*/
+typedef struct {
+    void *extra;
+    const t_pixel *origin;
+    ptrdiff_t stride;
+} t_bmp24_padded;
+
+typedef struct {
+    const t_bmp24 *img;
+    uint8_t *buffer;
+    size_t stride;
+    int radius;
+    t_border border;
+} t_bmp24_padTask;
+
+static void bmp24_padTask(void *arg, int start, int stop, int worker) {
+    t_bmp24_padTask *t = arg;
+    (void)worker;
+    for (int py = start; py < stop; py++) {
+        int y = borderIndex(&t->border, py - t->radius, t->img->height);
+        const uint8_t *src = (y < 0) ? NULL : (const uint8_t *)bmp24_row(t->img, y);
+        borderPadRow(&t->border, src, t->buffer + (size_t)py * t->stride, t->img->width, t->radius,
+                     (int)sizeof(t_pixel));
     }
+}
 
-    bmp24_free(tmp);
-    freeKernel(kernel);
+/*
+Copie l'image dans un buffer aligné agrandi de radius pixels de chaque côté
+- Halo rempli selon le mode de bord courant (voir borderSet), lignes réparties sur le pool
+- Copie et zone extra (extra octets, alignée) sont prises dans le buffer de travail de l'image :
+  rien à libérer, et pas d'allocation quand un filtre précédent a déjà réservé assez de place
+- Retourne 0, ou -1 si l'allocation échoue
+*/
+static int bmp24_padImage(t_bmp24 *img, int radius, size_t extra, t_bmp24_padded *padded) {
+    t_bmp24_padTask task;
+    task.img = img;
+    task.stride = (size_t)bmp24_computeStride(img->width + 2 * radius);
+    task.radius = radius;
+    task.border = borderGet();
+    size_t padSize = task.stride * ((size_t)img->height + 2 * (size_t)radius);
+    padSize = (padSize + BMP24_ALIGNMENT - 1) / BMP24_ALIGNMENT * BMP24_ALIGNMENT;
+    task.buffer = bmp24_scratch(img, padSize + extra);
+    if (!task.buffer) return -1;
+
+    parallel_for(img->height + 2 * radius, BMP24_FILTER_GRAIN, bmp24_padTask, &task);
+    padded->extra = task.buffer + padSize;
+    padded->origin = (const t_pixel *)(task.buffer + (size_t)radius * task.stride) + radius;
+    padded->stride = (ptrdiff_t)task.stride;
+    return 0;
+}
+
+// Ligne y d'une copie agrandie (y peut être dans le halo)
+static inline const t_pixel *bmp24_paddedRow(const t_bmp24_padded *padded, int y) {
+    return (const t_pixel *)((const uint8_t *)padded->origin + (ptrdiff_t)y * padded->stride);
 }
 
 /*
-Applique un filtre gaussien à l'image
-- Crée un noyau gaussien 3x3
-- Applique la convolution à toute l'image
+Contexte partagé par les tâches de convolution (une tuile = un groupe de lignes)
+- src : copie agrandie de l'image, tous les voisins y sont présents (pas de tests de bords)
+- Les résultats sont écrits directement dans img (les lectures se font dans la copie) :
+  chaque ligne n'est écrite que par une tuile, résultat identique quel que soit le nombre de threads
 */
-void bmp24_gaussianBlur(t_bmp24 *img) {
-    float **kernel = createGaussianBlurKernel();
-    t_bmp24 *tmp = bmp24_allocate(img->width, img->height, img->colorDepth);
-    if (!tmp) {
-        freeKernel(kernel);
-        return;
-    }
+typedef struct {
+    t_bmp24 *img;
+    t_bmp24_padded src;
+    const t_kernel *kernel;
+    t_kernelDivider divider;    // chemins entiers
+    void *scratch;              // anneau + accumulateur (float ou int32), un bloc par thread
+    size_t scratchCount;
+} t_bmp24_filterTask;
 
-    for (int y = 0; y < img->height; y++) {
-        for (int x = 0; x < img->width; x++) {
-            tmp->data[y][x] = bmp24_convolution(img, x, y, kernel, 3);
+/*
+Passe séparable (horizontale puis verticale) sur les lignes d'une tuile
+- rowKernel / colKernel : décomposition du noyau (voir separateKernel)
+- 2K multiplications par pixel et par composante au lieu de K²
+- Les résultats horizontaux (B, G, R) sont gardés dans un anneau de K lignes, propre au thread
+*/
+static void bmp24_separableTask(void *arg, int start, int stop, int worker) {
+    t_bmp24_filterTask *t = arg;
+    int kernelSize = t->kernel->size;
+    int offset = t->kernel->radius;
+    const float *rowKernel = t->kernel->rowKernel;
+    const float *colKernel = t->kernel->colKernel;
+    int width = t->img->width;
+    size_t rowFloats = (size_t)width * 3;
+
+    float *ring = (float *)t->scratch + (size_t)worker * t->scratchCount;
+    float *acc = ring + (size_t)kernelSize * rowFloats;
+
+    int next = start - offset;  // prochaine ligne à filtrer horizontalement (halo compris)
+    for (int y = start; y < stop; y++) {
+        // Passe horizontale des lignes manquantes
+        while (next <= y + offset) {
+            const t_pixel *src = bmp24_paddedRow(&t->src, next);
+            float *h = ring + (size_t)((next + offset) % kernelSize) * rowFloats;
+            for (int x = 0; x < width; x++) {
+                float b = 0.0f, g = 0.0f, r = 0.0f;
+                for (int j = -offset; j <= offset; j++) {
+                    b += src[x + j].blue  * rowKernel[j + offset];
+                    g += src[x + j].green * rowKernel[j + offset];
+                    r += src[x + j].red   * rowKernel[j + offset];
+                }
+                h[3 * x]     = b;
+                h[3 * x + 1] = g;
+                h[3 * x + 2] = r;
+            }
+            next++;
+        }
+
+        // Passe verticale sur les K lignes de l'anneau
+        for (size_t k = 0; k < rowFloats; k++) acc[k] = 0.0f;
+        for (int i = -offset; i <= offset; i++) {
+            const float *h = ring + (size_t)((y + i + offset) % kernelSize) * rowFloats;
+            float coef = colKernel[i + offset];
+            for (size_t k = 0; k < rowFloats; k++) {
+                acc[k] += h[k] * coef;
+            }
+        }
+
+        t_pixel *out = bmp24_row(t->img, y);
+        for (int x = 0; x < width; x++) {
+            float b = acc[3 * x], g = acc[3 * x + 1], r = acc[3 * x + 2];
+            out[x].blue  = (b > 255) ? 255 : (b < 0 ? 0 : (uint8_t)(b + 0.5));
+            out[x].green = (g > 255) ? 255 : (g < 0 ? 0 : (uint8_t)(g + 0.5));
+            out[x].red   = (r > 255) ? 255 : (r < 0 ? 0 : (uint8_t)(r + 0.5));
         }
     }
+}
 
-    for (int y = 0; y < img->height; y++) {
-        for (int x = 0; x < img->width; x++) {
-            img->data[y][x] = tmp->data[y][x];
+/*
+Passe séparable entière : même parcours que bmp24_separableTask, sommes exactes sur 32 bits
+- Noyau symétrique : les pixels à égale distance du centre sont additionnés avant la
+  multiplication (K/2 + 1 multiplications au lieu de K)
+*/
+static void bmp24_separableIntTask(void *arg, int start, int stop, int worker) {
+    t_bmp24_filterTask *t = arg;
+    int kernelSize = t->kernel->size;
+    int offset = t->kernel->radius;
+    const int32_t *intRow = t->kernel->intRow;
+    const int32_t *intCol = t->kernel->intCol;
+    int symmetric = t->kernel->symmetric;
+    int width = t->img->width;
+    size_t rowValues = (size_t)width * 3;
+
+    int32_t *ring = (int32_t *)t->scratch + (size_t)worker * t->scratchCount;
+    int32_t *acc = ring + (size_t)kernelSize * rowValues;
+
+    int next = start - offset;
+    for (int y = start; y < stop; y++) {
+        while (next <= y + offset) {
+            const t_pixel *src = bmp24_paddedRow(&t->src, next);
+            int32_t *h = ring + (size_t)((next + offset) % kernelSize) * rowValues;
+            for (int x = 0; x < width; x++) {
+                int32_t b, g, r;
+                if (symmetric) {
+                    b = src[x].blue  * intRow[offset];
+                    g = src[x].green * intRow[offset];
+                    r = src[x].red   * intRow[offset];
+                    for (int j = 1; j <= offset; j++) {
+                        int32_t coef = intRow[offset + j];
+                        b += (src[x - j].blue  + src[x + j].blue)  * coef;
+                        g += (src[x - j].green + src[x + j].green) * coef;
+                        r += (src[x - j].red   + src[x + j].red)   * coef;
+                    }
+                } else {
+                    b = g = r = 0;
+                    for (int j = -offset; j <= offset; j++) {
+                        b += src[x + j].blue  * intRow[j + offset];
+                        g += src[x + j].green * intRow[j + offset];
+                        r += src[x + j].red   * intRow[j + offset];
+                    }
+                }
+                h[3 * x]     = b;
+                h[3 * x + 1] = g;
+                h[3 * x + 2] = r;
+            }
+            next++;
+        }
+
+        for (size_t k = 0; k < rowValues; k++) acc[k] = 0;
+        for (int i = -offset; i <= offset; i++) {
+            const int32_t *h = ring + (size_t)((y + i + offset) % kernelSize) * rowValues;
+            int32_t coef = intCol[i + offset];
+            for (size_t k = 0; k < rowValues; k++) {
+                acc[k] += h[k] * coef;
+            }
+        }
+
+        t_pixel *out = bmp24_row(t->img, y);
+        for (int x = 0; x < width; x++) {
+            out[x].blue  = kernelDivide(&t->divider, acc[3 * x]);
+            out[x].green = kernelDivide(&t->divider, acc[3 * x + 1]);
+            out[x].red   = kernelDivide(&t->divider, acc[3 * x + 2]);
         }
     }
+}
 
-    bmp24_free(tmp);
-    freeKernel(kernel);
+// Voisin (dx, dy) d'un pixel dans un buffer de lignes séparées de stride octets
+static inline const t_pixel *bmp24_tapPixel(const t_pixel *src, ptrdiff_t stride, const t_kernelTap *tap) {
+    return (const t_pixel *)((const uint8_t *)(src + tap->dx) + (ptrdiff_t)tap->dy * stride);
 }
 
 /*
-Applique un filtre de détection de contours
-- Crée un noyau spécifique
-- Applique la convolution à toute l'image
+Convolution d'une ligne sur les coefficients non nuls du noyau
+- src : pixel 0 de la ligne dans un buffer agrandi d'au moins kernel->radius pixels de chaque côté
+- stride : écart en octets entre deux lignes (négatif pour des lignes de bas en haut)
+- Même ordre de sommation que bmp24_convolution : même arrondi, sans tests de bords
 */
-void bmp24_outline(t_bmp24 *img) {
-    float **kernel = createOutlineKernel();
-    t_bmp24 *tmp = bmp24_allocate(img->width, img->height, img->colorDepth);
-    if (!tmp) {
-        freeKernel(kernel);
-        return;
+static void bmp24_convolveRow(const t_kernel *kernel, const t_pixel *src, ptrdiff_t stride,
+                              t_pixel *dst, int width) {
+    for (int x = 0; x < width; x++) {
+        float r = 0.0, g = 0.0, b = 0.0;
+        for (int k = 0; k < kernel->tapCount; k++) {
+            const t_kernelTap *tap = &kernel->taps[k];
+            const t_pixel *p = bmp24_tapPixel(src + x, stride, tap);
+            r += p->red   * tap->value;
+            g += p->green * tap->value;
+            b += p->blue  * tap->value;
+        }
+        dst[x].red   = (r > 255) ? 255 : (r < 0 ? 0 : (uint8_t)(r + 0.5));
+        dst[x].green = (g > 255) ? 255 : (g < 0 ? 0 : (uint8_t)(g + 0.5));
+        dst[x].blue  = (b > 255) ? 255 : (b < 0 ? 0 : (uint8_t)(b + 0.5));
     }
+}
 
-    for (int y = 0; y < img->height; y++) {
-        for (int x = 0; x < img->width; x++) {
-            tmp->data[y][x] = bmp24_convolution(img, x, y, kernel, 3);
+/*
+Version entière de bmp24_convolveRow (voir bmp24_convolutionInt)
+*/
+static void bmp24_convolveRowInt(const t_kernel *kernel, const t_kernelDivider *divider,
+                                 const t_pixel *src, ptrdiff_t stride, t_pixel *dst, int width) {
+    for (int x = 0; x < width; x++) {
+        int32_t r = 0, g = 0, b = 0;
+        for (int k = 0; k < kernel->tapCount; k++) {
+            const t_kernelTap *tap = &kernel->taps[k];
+            const t_pixel *p = bmp24_tapPixel(src + x, stride, tap);
+            r += p->red   * tap->weight;
+            g += p->green * tap->weight;
+            b += p->blue  * tap->weight;
         }
+        dst[x].red   = kernelDivide(divider, r);
+        dst[x].green = kernelDivide(divider, g);
+        dst[x].blue  = kernelDivide(divider, b);
     }
+}
 
-    for (int y = 0; y < img->height; y++) {
-        for (int x = 0; x < img->width; x++) {
-            img->data[y][x] = tmp->data[y][x];
-        }
+/*
+Noyau complet en entiers sur les lignes d'une tuile (coefficients non nuls seulement)
+*/
+static void bmp24_kernelIntTask(void *arg, int start, int stop, int worker) {
+    t_bmp24_filterTask *t = arg;
+    (void)worker;
+    for (int y = start; y < stop; y++) {
+        bmp24_convolveRowInt(t->kernel, &t->divider, bmp24_paddedRow(&t->src, y), t->src.stride,
+                             bmp24_row(t->img, y), t->img->width);
     }
+}
 
-    bmp24_free(tmp);
-    freeKernel(kernel);
+/*
+Noyau complet en flottant : même découpage que bmp24_kernelIntTask
+*/
+static void bmp24_kernelTask(void *arg, int start, int stop, int worker) {
+    t_bmp24_filterTask *t = arg;
+    (void)worker;
+    for (int y = start; y < stop; y++) {
+        bmp24_convolveRow(t->kernel, bmp24_paddedRow(&t->src, y), t->src.stride,
+                          bmp24_row(t->img, y), t->img->width);
+    }
 }
 
 /*
-Applique un filtre de relief (emboss)
-- Crée un noyau spécifique
-- Applique la convolution à toute l'image
+Applique un noyau de convolution à toute l'image
+- L'image est d'abord copiée avec un halo de kernel->radius pixels (mode de bord : voir borderSet),
+  le résultat est écrit directement dans l'image
+- Le calcul est choisi d'après les métadonnées du noyau :
+  - séparable et rationnel (flou moyen, gaussien) : deux passes 1D entières
+  - rationnel (entiers / diviseur) : calcul entier exact
+  - séparable : deux passes 1D en flottant
+  - sinon, noyau complet en flottant
+- Les lignes sont réparties sur le pool de threads
 */
-void bmp24_emboss(t_bmp24 *img) {
-    float **kernel = createEmbossKernel();
-    t_bmp24 *tmp = bmp24_allocate(img->width, img->height, img->colorDepth);
-    if (!tmp) {
-        freeKernel(kernel);
-        return;
+void bmp24_applyKernel(t_bmp24 *img, const t_kernel *kernel) {
+    if (img == NULL || kernel == NULL) return;
+
+    t_bmp24_filterTask task;
+    memset(&task, 0, sizeof(task));
+    task.img = img;
+    task.kernel = kernel;
+    // Un anneau de K lignes + un accumulateur par thread (float ou int32, 4 octets)
+    size_t extra = 0;
+    if (kernel->separable) {
+        task.scratchCount = (size_t)(kernel->size + 1) * img->width * 3;
+        extra = parallel_getThreadCount() * task.scratchCount * sizeof(float);
+    }
+    if (bmp24_padImage(img, kernel->radius, extra, &task.src) != 0) return;
+    task.scratch = task.src.extra;
+    int separable = kernel->separable;
+
+    if (separable && kernel->separableDivisor) {
+        kernelDividerInit(&task.divider, kernel->separableDivisor);
+        parallel_for(img->height, BMP24_FILTER_GRAIN, bmp24_separableIntTask, &task);
+    } else if (kernel->divisor) {
+        kernelDividerInit(&task.divider, kernel->divisor);
+        parallel_for(img->height, BMP24_FILTER_GRAIN, bmp24_kernelIntTask, &task);
+    } else if (separable) {
+        parallel_for(img->height, BMP24_FILTER_GRAIN, bmp24_separableTask, &task);
+    } else {
+        parallel_for(img->height, BMP24_FILTER_GRAIN, bmp24_kernelTask, &task);
     }
+}
 
-    for (int y = 0; y < img->height; y++) {
-        for (int x = 0; x < img->width; x++) {
-            tmp->data[y][x] = bmp24_convolution(img, x, y, kernel, 3);
+/*
+Applique un filtre donné sous forme de matrice float ** (voir bmp24_applyKernel)
+*/
+void bmp24_applyFilter(t_bmp24 *img, float **kernel, int kernelSize) {
+    t_kernel *k = createKernelFromMatrix(kernel, kernelSize);
+    if (!k) return;
+    bmp24_applyKernel(img, k);
+    destroyKernel(k);
+}
+
+/*
+Contexte du flou moyen par sommes glissantes (une tuile = un groupe de lignes)
+- src : copie agrandie de radius pixels (voir bmp24_padImage)
+*/
+typedef struct {
+    t_bmp24 *img;
+    t_bmp24_padded src;
+    int radius;
+    t_kernelDivider divider;    // division arrondie par (2 radius + 1)²
+    int32_t *scratch;           // sommes de colonnes + 2 lignes de sommes horizontales, par thread
+    size_t scratchCount;
+} t_bmp24_boxTask;
+
+/*
+Sommes horizontales glissantes d'une ligne agrandie (B, G, R entrelacés) :
+sums[3x + c] = somme des composantes c de src[x - radius] ... src[x + radius], x dans [0, width)
+*/
+static void bmp24_boxRowSums(const t_pixel *src, int width, int radius, int32_t *sums) {
+    int32_t b = 0, g = 0, r = 0;
+    for (int x = -radius; x <= radius; x++) {
+        b += src[x].blue;
+        g += src[x].green;
+        r += src[x].red;
+    }
+    sums[0] = b;
+    sums[1] = g;
+    sums[2] = r;
+    for (int x = 1; x < width; x++) {
+        const t_pixel *in = &src[x + radius], *out = &src[x - radius - 1];
+        b += in->blue  - out->blue;
+        g += in->green - out->green;
+        r += in->red   - out->red;
+        sums[3 * x]     = b;
+        sums[3 * x + 1] = g;
+        sums[3 * x + 2] = r;
+    }
+}
+
+/*
+Flou moyen sur les lignes d'une tuile
+- Sommes de colonnes initialisées sur les lignes [start - radius, start + radius] de la copie,
+  puis mises à jour à chaque ligne (ligne entrante ajoutée, ligne sortante retirée)
+- Coût par pixel constant, quel que soit le rayon
+*/
+static void bmp24_boxTask(void *arg, int start, int stop, int worker) {
+    t_bmp24_boxTask *t = arg;
+    int radius = t->radius;
+    int width = t->img->width;
+    size_t rowValues = (size_t)width * 3;
+
+    int32_t *cols = t->scratch + (size_t)worker * t->scratchCount;
+    int32_t *incoming = cols + rowValues;
+    int32_t *outgoing = incoming + rowValues;
+
+    for (size_t k = 0; k < rowValues; k++) cols[k] = 0;
+    for (int i = start - radius; i <= start + radius; i++) {
+        bmp24_boxRowSums(bmp24_paddedRow(&t->src, i), width, radius, incoming);
+        for (size_t k = 0; k < rowValues; k++) cols[k] += incoming[k];
+    }
+
+    for (int y = start; y < stop; y++) {
+        if (y > start) {
+            bmp24_boxRowSums(bmp24_paddedRow(&t->src, y + radius), width, radius, incoming);
+            bmp24_boxRowSums(bmp24_paddedRow(&t->src, y - radius - 1), width, radius, outgoing);
+            for (size_t k = 0; k < rowValues; k++) cols[k] += incoming[k] - outgoing[k];
+        }
+
+        t_pixel *out = bmp24_row(t->img, y);
+        for (int x = 0; x < width; x++) {
+            out[x].blue  = kernelDivide(&t->divider, cols[3 * x]);
+            out[x].green = kernelDivide(&t->divider, cols[3 * x + 1]);
+            out[x].red   = kernelDivide(&t->divider, cols[3 * x + 2]);
         }
     }
+}
 
-    for (int y = 0; y < img->height; y++) {
-        for (int x = 0; x < img->width; x++) {
-            img->data[y][x] = tmp->data[y][x];
+/*
+Flou moyen de rayon quelconque ((2 radius + 1)² pixels) par sommes glissantes
+- Même résultat que bmp24_applyKernel avec createBoxKernel(radius) : même halo, sommes entières
+  exactes divisées par (2 radius + 1)², arrondi au plus proche
+- Coût par pixel indépendant du rayon (4 additions par composante)
+- radius est limité à KERNEL_MAX_BOX_RADIUS
+*/
+void bmp24_boxBlurRadius(t_bmp24 *img, int radius) {
+    if (img == NULL || radius <= 0 || img->width <= 0 || img->height <= 0) return;
+    if (radius > KERNEL_MAX_BOX_RADIUS) radius = KERNEL_MAX_BOX_RADIUS;
+
+    t_bmp24_boxTask task;
+    memset(&task, 0, sizeof(task));
+    task.img = img;
+    task.radius = radius;
+    task.scratchCount = (size_t)img->width * 3 * 3;
+    size_t extra = parallel_getThreadCount() * task.scratchCount * sizeof(int32_t);
+    if (bmp24_padImage(img, radius, extra, &task.src) != 0) return;
+    task.scratch = task.src.extra;
+    kernelDividerInit(&task.divider, (2 * radius + 1) * (2 * radius + 1));
+
+    // Chaque tuile relit 2 radius + 1 lignes pour initialiser ses sommes : tuiles d'au moins autant de lignes
+    int grain = (2 * radius + 1 > BMP24_FILTER_GRAIN) ? 2 * radius + 1 : BMP24_FILTER_GRAIN;
+    parallel_for(img->height, grain, bmp24_boxTask, &task);
+}
+
+// Nombre minimal de valeurs (3 par pixel) par tuile pour la passe verticale du flou gaussien récursif
+#define BMP24_IIR_COLUMN_GRAIN 192
+
+/*
+Contexte du flou gaussien récursif : plan flottant B, G, R entrelacés, filtré en place
+*/
+typedef struct {
+    t_bmp24 *img;
+    float *plane;
+    t_recursiveGaussian coefs;
+} t_bmp24_iirTask;
+
+/*
+Passe horizontale : conversion des lignes en flottants puis filtrage aller-retour de chaque composante
+*/
+static void bmp24_iirRowsTask(void *arg, int start, int stop, int worker) {
+    t_bmp24_iirTask *t = arg;
+    int width = t->img->width;
+    size_t rowValues = (size_t)width * 3;
+    (void)worker;
+
+    for (int y = start; y < stop; y++) {
+        const uint8_t *src = (const uint8_t *)bmp24_row(t->img, y);
+        float *row = t->plane + (size_t)y * rowValues;
+        for (size_t k = 0; k < rowValues; k++) row[k] = src[k];
+        for (int c = 0; c < 3; c++) {
+            recursiveGaussianLine(&t->coefs, row + c, width, 3);
         }
     }
+}
+
+/*
+Passe verticale sur un groupe de valeurs d'une ligne, puis écriture du résultat arrondi dans l'image
+*/
+static void bmp24_iirColumnsTask(void *arg, int start, int stop, int worker) {
+    t_bmp24_iirTask *t = arg;
+    size_t rowValues = (size_t)t->img->width * 3;
+    int height = t->img->height;
+    (void)worker;
+
+    recursiveGaussianColumns(&t->coefs, t->plane, rowValues, height, start, stop);
+    for (int y = 0; y < height; y++) {
+        const float *row = t->plane + (size_t)y * rowValues;
+        uint8_t *dst = (uint8_t *)bmp24_row(t->img, y);
+        for (int k = start; k < stop; k++) {
+            float v = row[k] + 0.5f;
+            dst[k] = (v <= 0.0f) ? 0 : (v >= 255.0f ? 255 : (uint8_t)v);
+        }
+    }
+}
+
+/*
+Flou gaussien d'écart type quelconque par filtre récursif (voir recursiveGaussianInit)
+- Coût par pixel constant, quel que soit sigma (adapté aux grands sigma, 10 à 30 et plus)
+- Lignes puis colonnes réparties sur le pool de threads
+- Bords : pixels du bord répétés
+- sigma doit être au moins RECURSIVE_GAUSSIAN_MIN_SIGMA
+- Retourne 0 en cas de succès, -1 en cas d'erreur (image inchangée)
+*/
+int bmp24_gaussianBlurSigma(t_bmp24 *img, float sigma) {
+    if (img == NULL) return -1;
+
+    t_bmp24_iirTask task;
+    task.img = img;
+    if (recursiveGaussianInit(&task.coefs, sigma) != 0) return -1;
+    // Plan flottant pris dans le buffer de travail de l'image (voir bmp24_scratch)
+    task.plane = bmp24_scratch(img, (size_t)img->width * img->height * 3 * sizeof(float));
+    if (!task.plane) {
+        printf("Erreur d'allocation mémoire pour le filtre.\n");
+        return -1;
+    }
+
+    parallel_for(img->height, BMP24_FILTER_GRAIN, bmp24_iirRowsTask, &task);
+    parallel_for(img->width * 3, BMP24_IIR_COLUMN_GRAIN, bmp24_iirColumnsTask, &task);
+    return 0;
+}
+
+/*
+Applique un filtre box blur à l'image
+- Flou moyen 3x3 (même résultat que le noyau createBoxBlurKernel)
+- Sommes glissantes, voir bmp24_boxBlurRadius
+*/
+void bmp24_boxBlur(t_bmp24 *img) {
+    bmp24_boxBlurRadius(img, 1);
+}
 
-    bmp24_free(tmp);
+/*
+Applique un filtre gaussien à l'image
+- Crée un noyau gaussien 3x3
+- Applique la convolution à toute l'image
+*/
+void bmp24_gaussianBlur(t_bmp24 *img) {
+    float **kernel = createGaussianBlurKernel();
+    bmp24_applyFilter(img, kernel, 3);
+    freeKernel(kernel);
+}
+
+/*
+Applique un filtre de détection de contours
+- Crée un noyau spécifique
+- Applique la convolution à toute l'image
+*/
+void bmp24_outline(t_bmp24 *img) {
+    float **kernel = createOutlineKernel();
+    bmp24_applyFilter(img, kernel, 3);
+    freeKernel(kernel);
+}
+
+/*
+Applique un filtre de relief (emboss)
+- Crée un noyau spécifique
+- Applique la convolution à toute l'image
+*/
+void bmp24_emboss(t_bmp24 *img) {
+    float **kernel = createEmbossKernel();
+    bmp24_applyFilter(img, kernel, 3);
     freeKernel(kernel);
 }
 
@@ -408,82 +1304,363 @@ Applique un filtre de netteté (sharpen)
 */
 void bmp24_sharpen(t_bmp24 *img) {
     float **kernel = createSharpenKernel();
-    t_bmp24 *tmp = bmp24_allocate(img->width, img->height, img->colorDepth);
-    if (!tmp) {
-        freeKernel(kernel);
-        return;
+    bmp24_applyFilter(img, kernel, 3);
+    freeKernel(kernel);
+}
+
+/*
+Applique un filtre de convolution sans charger l'image entière
+- Lit le fichier par bandes de bandHeight lignes, avec un halo de kernel->radius lignes
+  de chaque côté, filtre la bande puis l'écrit directement dans le fichier de sortie
+- Chaque bande est recopiée avec son halo complété selon le mode de bord (voir borderSet) ;
+  les lignes de halo situées loin de la bande (BORDER_WRAP, BORDER_REFLECT) sont relues à part
+- Mémoire utilisée : environ 3 bandes, quelle que soit la taille de l'image
+- Mêmes bords et mêmes résultats que bmp24_applyKernel (à l'arrondi flottant près pour les
+  noyaux non rationnels) ; les lignes du fichier sont de bas en haut : la bande est parcourue
+  avec un stride négatif
+- Retourne 0 en cas de succès, -1 en cas d'erreur
+*/
+int bmp24_applyKernelStreamed(const char *inputFile, const char *outputFile,
+                              const t_kernel *kernel, int bandHeight) {
+    if (kernel == NULL) return -1;
+
+    FILE *in = fopen(inputFile, "rb");
+    if (!in) {
+        printf("Erreur : impossible d ouvrir le fichier %s\n", inputFile);
+        return -1;
     }
 
-    for (int y = 0; y < img->height; y++) {
-        for (int x = 0; x < img->width; x++) {
-            tmp->data[y][x] = bmp24_convolution(img, x, y, kernel, 3);
-        }
+    t_bmp_header header;
+    t_bmp_info info;
+    if (fread(&header, sizeof(t_bmp_header), 1, in) != 1 || fread(&info, sizeof(t_bmp_info), 1, in) != 1) {
+        printf("Erreur : en-tete illisible dans %s\n", inputFile);
+        fclose(in);
+        return -1;
+    }
+    if (info.bits != 24 || info.width <= 0 || info.height <= 0 || header.offset < HEADER_SIZE + INFO_SIZE) {
+        printf("Erreur : image non 24 bits (%d bits detectes)\n", info.bits);
+        fclose(in);
+        return -1;
     }
 
-    for (int y = 0; y < img->height; y++) {
-        for (int x = 0; x < img->width; x++) {
-            img->data[y][x] = tmp->data[y][x];
+    int w = info.width, h = info.height;
+    int off = kernel->radius;
+    if (bandHeight <= 0) bandHeight = BMP24_DEFAULT_BAND_HEIGHT;
+    size_t rowBytes = ((size_t)w * sizeof(t_pixel) + 3) & ~(size_t)3;
+    size_t padStride = ((size_t)w + 2 * (size_t)off) * sizeof(t_pixel);
+    int capacity = bandHeight + 2 * off;
+    t_border border = borderGet();
+
+    uint8_t *prefix = memory_alloc(header.offset);
+    uint8_t *window = memory_alloc((size_t)capacity * rowBytes);
+    uint8_t *padded = memory_alloc((size_t)capacity * padStride);
+    uint8_t *spare = memory_alloc(rowBytes);
+    uint8_t *band = memory_calloc((size_t)bandHeight, rowBytes);
+    FILE *out = fopen(outputFile, "wb");
+    if (!prefix || !window || !padded || !spare || !band || !out) {
+        printf("Erreur : impossible de preparer le filtrage de %s\n", inputFile);
+        memory_free(prefix); memory_free(window); memory_free(padded); memory_free(spare); memory_free(band);
+        if (out) fclose(out);
+        fclose(in);
+        return -1;
+    }
+
+    // En-têtes recopiés tels quels
+    fseek(in, 0, SEEK_SET);
+    int status = (fread(prefix, 1, header.offset, in) == header.offset
+                  && fwrite(prefix, 1, header.offset, out) == header.offset) ? 0 : -1;
+
+    // Noyau rationnel : même calcul entier exact que bmp24_applyKernel
+    t_kernelDivider divider;
+    int32_t divisor = kernel->divisor;
+    if (divisor) kernelDividerInit(&divider, divisor);
+
+    int first = 0;  // indice (dans le fichier) de la première ligne de window
+    int count = 0;  // nombre de lignes présentes dans window
+    for (int b0 = 0; status == 0 && b0 < h; b0 += bandHeight) {
+        int b1 = (b0 + bandHeight < h) ? b0 + bandHeight : h;
+        int need0 = (b0 - off > 0) ? b0 - off : 0;
+        int need1 = (b1 + off < h) ? b1 + off : h;
+
+        // Garder le halo de la bande précédente, puis lire les nouvelles lignes
+        if (need0 > first) {
+            int drop = need0 - first;
+            memmove(window, window + (size_t)drop * rowBytes, (size_t)(count - drop) * rowBytes);
+            first = need0;
+            count -= drop;
+        }
+        while (first + count < need1) {
+            if (fread(window + (size_t)count * rowBytes, 1, rowBytes, in) != rowBytes) {
+                printf("Erreur : donnees pixels incompletes dans %s\n", inputFile);
+                status = -1;
+                break;
+            }
+            count++;
+        }
+        if (status != 0) break;
+
+        // Bande agrandie : lignes [b0 - off, b1 + off) du fichier complétées selon le mode de bord
+        // (le miroir et la répétition donnent les mêmes lignes dans l'ordre du fichier)
+        for (int p = b0 - off; status == 0 && p < b1 + off; p++) {
+            int f = borderIndex(&border, p, h);
+            const uint8_t *src = NULL;
+            if (f >= first && f < first + count) {
+                src = window + (size_t)(f - first) * rowBytes;
+            } else if (f >= 0) {
+                // Ligne hors de la fenêtre : lue à part, puis retour à la position de lecture
+                if (fseek(in, (long)(header.offset + (size_t)f * rowBytes), SEEK_SET) != 0
+                    || fread(spare, 1, rowBytes, in) != rowBytes
+                    || fseek(in, (long)(header.offset + (size_t)(first + count) * rowBytes), SEEK_SET) != 0) {
+                    printf("Erreur : donnees pixels incompletes dans %s\n", inputFile);
+                    status = -1;
+                    break;
+                }
+                src = spare;
+            }
+            borderPadRow(&border, src, padded + (size_t)(p - b0 + off) * padStride, w, off,
+                         (int)sizeof(t_pixel));
+        }
+        if (status != 0) break;
+
+        // ligne i du noyau (vers le bas de l'image) = ligne f - i du fichier : stride négatif
+        for (int f = b0; f < b1; f++) {
+            const t_pixel *src = (const t_pixel *)(padded + (size_t)(f - b0 + off) * padStride) + off;
+            t_pixel *dst = (t_pixel *)(band + (size_t)(f - b0) * rowBytes);
+            if (divisor) {
+                bmp24_convolveRowInt(kernel, &divider, src, -(ptrdiff_t)padStride, dst, w);
+            } else {
+                bmp24_convolveRow(kernel, src, -(ptrdiff_t)padStride, dst, w);
+            }
+        }
+
+        size_t bandBytes = (size_t)(b1 - b0) * rowBytes;
+        if (fwrite(band, 1, bandBytes, out) != bandBytes) {
+            printf("Erreur lors de l ecriture des pixels\n");
+            status = -1;
         }
     }
 
-    bmp24_free(tmp);
-    freeKernel(kernel);
+    memory_free(prefix);
+    memory_free(window);
+    memory_free(padded);
+    memory_free(spare);
+    memory_free(band);
+    fclose(in);
+    if (fclose(out) != 0) status = -1;
+    if (status == 0) printf("Filtre applique par bandes dans %s\n", outputFile);
+    return status;
+}
+
+/*
+Version float ** de bmp24_applyKernelStreamed
+*/
+int bmp24_applyFilterStreamed(const char *inputFile, const char *outputFile,
+                              float **kernel, int kernelSize, int bandHeight) {
+    t_kernel *k = createKernelFromMatrix(kernel, kernelSize);
+    if (!k) return -1;
+    int status = bmp24_applyKernelStreamed(inputFile, outputFile, k, bandHeight);
+    destroyKernel(k);
+    return status;
 }
 
 #include <math.h> // pour round()
 
+// Nombre minimal de lignes par tuile pour les histogrammes
+#define BMP24_HISTOGRAM_GRAIN 16
+
 /*
-Applique l'égalisation d'histogramme à une image couleur
-- Convertit en espace YUV
-- Égalise la composante Y (luminance)
-- Reconversion en RGB
+Contexte des histogrammes 24 bits : 6 x 256 compteurs par thread
+- Par composante, deux sous-histogrammes entrelacés (pixels pairs / impairs)
 */
-void bmp24_equalize(t_bmp24 *img) {
-    if (!img || !img->data) return;
+typedef struct {
+    t_bmp24 *img;
+    unsigned int *counts;
+} t_bmp24_histogramTask;
+
+/*
+Histogrammes par composante des lignes d'une tuile
+- Deux pixels par itération, six compteurs distincts : pas de dépendance entre incréments successifs
+*/
+static void bmp24_histogramTask(void *arg, int start, int stop, int worker) {
+    t_bmp24_histogramTask *t = arg;
+    unsigned int *h = t->counts + (size_t)worker * 6 * 256;
+    int width = t->img->width;
+
+    for (int y = start; y < stop; y++) {
+        const t_pixel *row = bmp24_row(t->img, y);
+        int x = 0;
+        for (; x + 2 <= width; x += 2) {
+            h[row[x].blue]++;
+            h[256 + row[x].green]++;
+            h[512 + row[x].red]++;
+            h[768 + row[x + 1].blue]++;
+            h[1024 + row[x + 1].green]++;
+            h[1280 + row[x + 1].red]++;
+        }
+        for (; x < width; x++) {
+            h[row[x].blue]++;
+            h[256 + row[x].green]++;
+            h[512 + row[x].red]++;
+        }
+    }
+}
 
-    int width = img->width;
-    int height = img->height;
+/*
+Luminance BT.601 en virgule fixe : approximation entière de 0.299 R + 0.587 G + 0.114 B arrondi
+- Coefficients x 2^16 de somme 65536 : résultat toujours dans [0, 255]
+*/
+static inline int bmp24_luma(t_pixel p) {
+    return (19595 * p.red + 38470 * p.green + 7471 * p.blue + 32768) >> 16;
+}
 
-    // Étapes 1-2 : allouer des tableaux pour Y, U, V
-    float **Y = malloc(height * sizeof(float *));
-    float **U = malloc(height * sizeof(float *));
-    float **V = malloc(height * sizeof(float *));
-    for (int i = 0; i < height; i++) {
-        Y[i] = malloc(width * sizeof(float));
-        U[i] = malloc(width * sizeof(float));
-        V[i] = malloc(width * sizeof(float));
+/*
+Histogramme de luminance des lignes d'une tuile (voir bmp24_luma)
+*/
+static void bmp24_lumaHistogramTask(void *arg, int start, int stop, int worker) {
+    t_bmp24_histogramTask *t = arg;
+    unsigned int *h = t->counts + (size_t)worker * 6 * 256;
+    int width = t->img->width;
+
+    for (int y = start; y < stop; y++) {
+        const t_pixel *row = bmp24_row(t->img, y);
+        int x = 0;
+        for (; x + 2 <= width; x += 2) {
+            h[bmp24_luma(row[x])]++;
+            h[256 + bmp24_luma(row[x + 1])]++;
+        }
+        for (; x < width; x++) {
+            h[bmp24_luma(row[x])]++;
+        }
     }
+}
 
-    // Étape 3 : convertir RGB → YUV et remplir les matrices
-    unsigned int *hist = calloc(256, sizeof(unsigned int));
-    for (int i = 0; i < height; i++) {
-        for (int j = 0; j < width; j++) {
-            t_pixel p = img->data[i][j];
+/*
+Lance une tâche d'histogramme sur le pool et additionne les sous-histogrammes
+- copies : nombre de sous-histogrammes remplis par thread
+- outputs : nombre d'histogrammes retournés, le sous-histogramme k est ajouté au k % outputs
+*/
+static unsigned int *bmp24_runHistogram(t_bmp24 *img, t_parallel_task taskFunction, int copies, int outputs) {
+    if (!img) return NULL;
+
+    int threads = parallel_getThreadCount();
+    unsigned int *hist = calloc((size_t)outputs * 256, sizeof(unsigned int));
+    unsigned int *counts = memory_calloc((size_t)threads * 6 * 256, sizeof(unsigned int));
+    if (!hist || !counts) {
+        printf("Erreur allocation histogramme\n");
+        free(hist);
+        memory_free(counts);
+        return NULL;
+    }
+
+    t_bmp24_histogramTask task = {img, counts};
+    parallel_for(img->height, BMP24_HISTOGRAM_GRAIN, taskFunction, &task);
+
+    for (int w = 0; w < threads; w++) {
+        for (int k = 0; k < copies; k++) {
+            unsigned int *dst = hist + (size_t)(k % outputs) * 256;
+            const unsigned int *src = counts + ((size_t)w * 6 + k) * 256;
+            for (int i = 0; i < 256; i++) dst[i] += src[i];
+        }
+    }
+    memory_free(counts);
+    return hist;
+}
 
-            float r = (float)p.red;
-            float g = (float)p.green;
-            float b = (float)p.blue;
+/*
+Histogrammes des trois composantes en un seul passage sur l'image
+- Retourne 3 x 256 compteurs : bleu [0, 256), vert [256, 512), rouge [512, 768) (à libérer par free)
+*/
+unsigned int *bmp24_computeHistograms(t_bmp24 *img) {
+    return bmp24_runHistogram(img, bmp24_histogramTask, 6, 3);
+}
 
-            float y = 0.299 * r + 0.587 * g + 0.114 * b;
-            float u = -0.14713 * r - 0.28886 * g + 0.436 * b;
-            float v =  0.615 * r - 0.51499 * g - 0.10001 * b;
+/*
+Histogramme de luminance (Y de BT.601, arrondi, voir bmp24_luma)
+- Retourne 256 compteurs (à libérer par free)
+*/
+unsigned int *bmp24_computeLumaHistogram(t_bmp24 *img) {
+    return bmp24_runHistogram(img, bmp24_lumaHistogramTask, 2, 1);
+}
 
-            // clamp y entre 0 et 255 avant histogramme
-            int y_int = (int)round(y);
-            if (y_int < 0) y_int = 0;
-            if (y_int > 255) y_int = 255;
+/*
+Contexte de l'égalisation YUV (une tuile = un groupe de lignes)
+*/
+typedef struct {
+    t_bmp24 *img;
+    const unsigned char *hist_eq;
+} t_bmp24_equalizeTask;
+
+// Nombre minimal de lignes par tuile pour l'égalisation
+#define BMP24_EQUALIZE_GRAIN 8
+
+// Coefficients x 2^16, arrondis au plus proche
+#define BMP24_FIXED(x) ((int32_t)((x) * 65536.0 + ((x) >= 0 ? 0.5 : -0.5)))
 
-            hist[y_int]++;
+/*
+Reconversion YUV → RGB exprimée directement en R, G, B : sortie = Y' + écart(R, G, B)
+- U = -0.14713 R - 0.28886 G + 0.436 B, V = 0.615 R - 0.51499 G - 0.10001 B
+- R' = Y' + 1.13983 V, G' = Y' - 0.39465 U - 0.58060 V, B' = Y' + 2.03211 U
+- Les produits sont développés une fois pour toutes : 3 coefficients par composante
+*/
+static const int32_t bmp24_equalizeRed[3] = {
+    BMP24_FIXED(1.13983 * 0.615), BMP24_FIXED(1.13983 * -0.51499), BMP24_FIXED(1.13983 * -0.10001)
+};
+static const int32_t bmp24_equalizeGreen[3] = {
+    BMP24_FIXED(-0.39465 * -0.14713 - 0.58060 * 0.615),
+    BMP24_FIXED(-0.39465 * -0.28886 - 0.58060 * -0.51499),
+    BMP24_FIXED(-0.39465 * 0.436 - 0.58060 * -0.10001)
+};
+static const int32_t bmp24_equalizeBlue[3] = {
+    BMP24_FIXED(2.03211 * -0.14713), BMP24_FIXED(2.03211 * -0.28886), BMP24_FIXED(2.03211 * 0.436)
+};
+
+// (valeur x 2^16) arrondie au plus proche, bornée à [0, 255]
+static inline unsigned char bmp24_fixedToByte(int32_t v) {
+    v = (v + 32768) >> 16;
+    return (unsigned char)(v < 0 ? 0 : (v > 255 ? 255 : v));
+}
 
-            Y[i][j] = y;
-            U[i][j] = u;
-            V[i][j] = v;
+/*
+Deuxième passage sur une tuile : Y recalculé, égalisé par la table, puis reconversion en RGB
+- Calcul entier par pixel, sans plans intermédiaires : même luminance que l'histogramme
+*/
+static void bmp24_equalizeTask(void *arg, int start, int stop, int worker) {
+    t_bmp24_equalizeTask *t = arg;
+    const int32_t *cr = bmp24_equalizeRed;
+    const int32_t *cg = bmp24_equalizeGreen;
+    const int32_t *cb = bmp24_equalizeBlue;
+    (void)worker;
+
+    for (int i = start; i < stop; i++) {
+        t_pixel *row = bmp24_row(t->img, i);
+        for (int j = 0; j < t->img->width; j++) {
+            t_pixel p = row[j];
+            int32_t y = (int32_t)t->hist_eq[bmp24_luma(p)] << 16;
+
+            row[j].red   = bmp24_fixedToByte(y + cr[0] * p.red + cr[1] * p.green + cr[2] * p.blue);
+            row[j].green = bmp24_fixedToByte(y + cg[0] * p.red + cg[1] * p.green + cg[2] * p.blue);
+            row[j].blue  = bmp24_fixedToByte(y + cb[0] * p.red + cb[1] * p.green + cb[2] * p.blue);
         }
     }
+}
 
-    // Étape 4 : CDF et normalisation
-    unsigned int *cdf = malloc(256 * sizeof(unsigned int));
-    unsigned int total = width * height;
+/*
+Applique l'égalisation d'histogramme à une image couleur
+- Premier passage : histogramme de la luminance Y
+- Deuxième passage : Y égalisé par la table, U et V recalculés, reconversion en RGB
+- Calcul entier en virgule fixe, sans plans Y/U/V intermédiaires (aucune mémoire par pixel)
+- Les deux passages sont répartis sur le pool de threads
+*/
+void bmp24_equalize(t_bmp24 *img) {
+    if (!img || !img->data) return;
+
+    // Premier passage : histogramme de la luminance
+    unsigned int *hist = bmp24_computeLumaHistogram(img);
+    if (!hist) return;
+
+    // CDF et normalisation
+    unsigned int total = (unsigned int)img->width * img->height;
+    unsigned int cdf[256];
     unsigned int cum = 0;
     for (int i = 0; i < 256; i++) {
         cum += hist[i];
@@ -499,43 +1676,315 @@ void bmp24_equalize(t_bmp24 *img) {
         }
     }
 
-    // hist_eq = tableau de correspondance
+    // hist_eq = tableau de correspondance (identité si l'image n'a qu'un niveau)
     unsigned char hist_eq[256];
     for (int i = 0; i < 256; i++) {
-        hist_eq[i] = (unsigned char)round(((float)(cdf[i] - cdf_min) / (total - cdf_min)) * 255);
+        hist_eq[i] = (total > cdf_min)
+                     ? (unsigned char)round(((float)(cdf[i] - cdf_min) / (total - cdf_min)) * 255)
+                     : (unsigned char)i;
     }
 
-    // Étape 5-6 : appliquer égalisation sur Y, puis reconvertir en RGB
-    for (int i = 0; i < height; i++) {
-        for (int j = 0; j < width; j++) {
-            int y_new = hist_eq[(int)round(Y[i][j])];
-            float u = U[i][j];
-            float v = V[i][j];
+    // Deuxième passage : égalisation de Y et reconversion en RGB
+    t_bmp24_equalizeTask task = {img, hist_eq};
+    parallel_for(img->height, BMP24_EQUALIZE_GRAIN, bmp24_equalizeTask, &task);
 
-            // YUV → RGB
-            int r = (int)round(y_new + 1.13983 * v);
-            int g = (int)round(y_new - 0.39465 * u - 0.58060 * v);
-            int b = (int)round(y_new + 2.03211 * u);
+    free(hist);
+    printf("Egalisation YUV terminee pour image couleur \n");
+}
 
-            // Clamp entre 0-255
-            if (r < 0) r = 0; if (r > 255) r = 255;
-            if (g < 0) g = 0; if (g > 255) g = 255;
-            if (b < 0) b = 0; if (b > 255) b = 255;
+/*
+Contexte CLAHE sur la luminance (voir bmp8_clahe, claheMapping et claheAxis)
+*/
+typedef struct {
+    t_bmp24 *img;
+    int tilesX;
+    int tilesY;
+    float clipLimit;
+    unsigned char *luts;
+    const int *firstX;
+    const int *weightX;
+    const int *firstY;
+    const int *weightY;
+    uint16_t *rowLuts;          // tables de la ligne courante (tilesX x 256), une par thread
+} t_bmp24_claheTask;
 
-            img->data[i][j].red = (unsigned char)r;
-            img->data[i][j].green = (unsigned char)g;
-            img->data[i][j].blue = (unsigned char)b;
+/*
+Premier passage : histogramme de luminance écrêté et table d'égalisation de chaque tuile [start, stop)
+*/
+static void bmp24_claheTilesTask(void *arg, int start, int stop, int worker) {
+    t_bmp24_claheTask *t = arg;
+    size_t width = t->img->width, height = t->img->height;
+    (void)worker;
+
+    for (int tile = start; tile < stop; tile++) {
+        int tx = tile % t->tilesX, ty = tile / t->tilesX;
+        size_t x0 = width * tx / t->tilesX, x1 = width * (tx + 1) / t->tilesX;
+        size_t y0 = height * ty / t->tilesY, y1 = height * (ty + 1) / t->tilesY;
+
+        unsigned int hist[256] = {0};
+        for (size_t y = y0; y < y1; y++) {
+            const t_pixel *row = bmp24_row(t->img, (int)y);
+            for (size_t x = x0; x < x1; x++) hist[bmp24_luma(row[x])]++;
         }
+        claheMapping(hist, (unsigned int)((x1 - x0) * (y1 - y0)), t->clipLimit,
+                     t->luts + (size_t)tile * 256);
     }
+}
 
-    // Nettoyage mémoire
-    for (int i = 0; i < height; i++) {
-        free(Y[i]);
-        free(U[i]);
-        free(V[i]);
+/*
+Deuxième passage : Y interpolé entre les tables des 4 tuiles voisines (x 2^16), puis
+reconversion en RGB comme bmp24_equalizeTask
+- Tables du haut et du bas mélangées une fois par ligne (voir bmp8_claheTask)
+*/
+static void bmp24_claheTask(void *arg, int start, int stop, int worker) {
+    t_bmp24_claheTask *t = arg;
+    const int32_t *cr = bmp24_equalizeRed;
+    const int32_t *cg = bmp24_equalizeGreen;
+    const int32_t *cb = bmp24_equalizeBlue;
+    int one = 1 << CLAHE_WEIGHT_BITS;
+    int shift = 2 * CLAHE_WEIGHT_BITS - 16;   // poids sur 2 x 8 bits -> virgule fixe 16 bits
+
+    for (int y = start; y < stop; y++) {
+        int ty0 = t->firstY[y], ty1 = ty0 + (ty0 < t->tilesY - 1);
+        int wy = t->weightY[y];
+        const unsigned char *top = t->luts + (size_t)ty0 * t->tilesX * 256;
+        const unsigned char *bottom = t->luts + (size_t)ty1 * t->tilesX * 256;
+        uint16_t *lut = t->rowLuts + (size_t)worker * t->tilesX * 256;
+        for (int k = 0; k < t->tilesX * 256; k++) {
+            lut[k] = (uint16_t)(top[k] * (one - wy) + bottom[k] * wy);
+        }
+
+        t_pixel *row = bmp24_row(t->img, y);
+        for (int x = 0; x < t->img->width; x++) {
+            int tx0 = t->firstX[x], tx1 = tx0 + (tx0 < t->tilesX - 1);
+            int wx = t->weightX[x];
+            t_pixel p = row[x];
+            int v = bmp24_luma(p);
+            int32_t luma = (lut[tx0 * 256 + v] * (one - wx) + lut[tx1 * 256 + v] * wx) << shift;
+
+            row[x].red   = bmp24_fixedToByte(luma + cr[0] * p.red + cr[1] * p.green + cr[2] * p.blue);
+            row[x].green = bmp24_fixedToByte(luma + cg[0] * p.red + cg[1] * p.green + cg[2] * p.blue);
+            row[x].blue  = bmp24_fixedToByte(luma + cb[0] * p.red + cb[1] * p.green + cb[2] * p.blue);
+        }
     }
-    free(Y); free(U); free(V);
-    free(hist); free(cdf);
+}
 
-    printf("Egalisation YUV terminee pour image couleur \n");
+/*
+Égalisation adaptative à contraste limité (CLAHE) d'une image couleur, sur la luminance
+- Même découpage et même interpolation que bmp8_clahe, U et V conservés (voir bmp24_equalize)
+- tilesX / tilesY <= 0 : CLAHE_DEFAULT_TILES
+*/
+void bmp24_clahe(t_bmp24 *img, int tilesX, int tilesY, float clipLimit) {
+    if (!img || !img->data || img->width <= 0 || img->height <= 0) return;
+    if (tilesX <= 0) tilesX = CLAHE_DEFAULT_TILES;
+    if (tilesY <= 0) tilesY = CLAHE_DEFAULT_TILES;
+    if (tilesX > img->width) tilesX = img->width;
+    if (tilesY > img->height) tilesY = img->height;
+
+    t_bmp24_claheTask task = {img, tilesX, tilesY, clipLimit, NULL, NULL, NULL, NULL, NULL, NULL};
+    task.luts = memory_alloc((size_t)tilesX * tilesY * 256);
+    task.rowLuts = memory_alloc((size_t)parallel_getThreadCount() * tilesX * 256 * sizeof(uint16_t));
+    int *axes = memory_alloc(2 * ((size_t)img->width + img->height) * sizeof(int));
+    if (!task.luts || !task.rowLuts || !axes) {
+        printf("Erreur allocation CLAHE\n");
+        memory_free(task.luts);
+        memory_free(task.rowLuts);
+        memory_free(axes);
+        return;
+    }
+    task.firstX = axes;
+    task.weightX = axes + img->width;
+    task.firstY = axes + 2 * (size_t)img->width;
+    task.weightY = task.firstY + img->height;
+    claheAxis(img->width, tilesX, axes, axes + img->width);
+    claheAxis(img->height, tilesY, axes + 2 * (size_t)img->width, axes + 2 * (size_t)img->width + img->height);
+
+    parallel_for(tilesX * tilesY, 1, bmp24_claheTilesTask, &task);
+    parallel_for(img->height, BMP24_EQUALIZE_GRAIN, bmp24_claheTask, &task);
+
+    memory_free(task.luts);
+    memory_free(task.rowLuts);
+    memory_free(axes);
+    printf("CLAHE applique  (tuiles %d x %d, limite %.1f)\n", tilesX, tilesY, clipLimit);
+}
+
+/* ---------------------------------------------------------------------------
+   Représentation planaire
+   --------------------------------------------------------------------------- */
+
+typedef struct {
+    t_bmp24 *img;
+    t_bmp24_planar *planar;
+} t_bmp24_planarTask;
+
+/*
+Prépare un plan 8 bits de width x height pixels
+- En-tête BMP 8 bits et palette de gris : le plan peut être enregistré par bmp8_saveImage
+*/
+static int bmp24_initPlane(t_bmp8 *plane, int width, int height) {
+    uint32_t dataSize = (uint32_t)width * (uint32_t)height;
+    uint32_t fields[][2] = {
+        {2, 54 + 1024 + dataSize}, {10, 54 + 1024}, {14, 40}, {18, (uint32_t)width},
+        {22, (uint32_t)height}, {34, dataSize}, {46, 256}
+    };
+
+    memset(plane, 0, sizeof(*plane));
+    plane->header[0] = 'B';
+    plane->header[1] = 'M';
+    for (size_t i = 0; i < sizeof(fields) / sizeof(fields[0]); i++) {
+        memcpy(&plane->header[fields[i][0]], &fields[i][1], sizeof(uint32_t));
+    }
+    plane->header[26] = 1;  // plans
+    plane->header[28] = 8;  // bits par pixel
+    for (int i = 0; i < 256; i++) {
+        plane->colorTable[4 * i] = plane->colorTable[4 * i + 1] = plane->colorTable[4 * i + 2] = (unsigned char)i;
+    }
+
+    plane->width = (unsigned int)width;
+    plane->height = (unsigned int)height;
+    plane->colorDepth = 8;
+    plane->dataSize = dataSize;
+    plane->data = memory_alloc(dataSize ? dataSize : 1);
+    return plane->data != NULL;
+}
+
+// Ligne y de l'image (haut en bas) dans un plan : lignes rangées comme dans le fichier (bas en haut)
+static uint8_t *bmp24_planeRow(const t_bmp8 *plane, int y) {
+    return plane->data + (size_t)(plane->height - 1 - (unsigned int)y) * plane->width;
+}
+
+static void bmp24_toPlanarTask(void *arg, int start, int stop, int worker) {
+    t_bmp24_planarTask *t = arg;
+    (void)worker;
+    for (int y = start; y < stop; y++) {
+        simd_deinterleave3((const uint8_t *)bmp24_row(t->img, y), bmp24_planeRow(&t->planar->blue, y),
+                           bmp24_planeRow(&t->planar->green, y), bmp24_planeRow(&t->planar->red, y),
+                           (size_t)t->img->width);
+    }
+}
+
+static void bmp24_fromPlanarTask(void *arg, int start, int stop, int worker) {
+    t_bmp24_planarTask *t = arg;
+    (void)worker;
+    for (int y = start; y < stop; y++) {
+        simd_interleave3(bmp24_planeRow(&t->planar->blue, y), bmp24_planeRow(&t->planar->green, y),
+                         bmp24_planeRow(&t->planar->red, y), (uint8_t *)bmp24_row(t->img, y),
+                         (size_t)t->img->width);
+    }
+}
+
+/*
+Sépare une image 24 bits en trois plans 8 bits (bleu, vert, rouge)
+- Conversion ligne par ligne, 16 pixels par instruction en SSSE3, lignes réparties sur le pool
+- Retourne NULL si l'allocation échoue ; libérer avec bmp24_freePlanar
+*/
+t_bmp24_planar *bmp24_toPlanar(const t_bmp24 *img) {
+    if (img == NULL || img->pixels == NULL) {
+        printf("Erreur : image invalide pour bmp24_toPlanar.\n");
+        return NULL;
+    }
+
+    t_bmp24_planar *planar = memory_alloc(sizeof(t_bmp24_planar));
+    if (!planar) {
+        printf("Erreur : echec de l allocation memoire\n");
+        return NULL;
+    }
+    int ok = bmp24_initPlane(&planar->blue, img->width, img->height);
+    ok = bmp24_initPlane(&planar->green, img->width, img->height) && ok;
+    ok = bmp24_initPlane(&planar->red, img->width, img->height) && ok;
+    if (!ok) {
+        printf("Erreur : echec de l allocation memoire\n");
+        bmp24_freePlanar(planar);
+        return NULL;
+    }
+
+    t_bmp24_planarTask task = {(t_bmp24 *)img, planar};
+    parallel_for(img->height, bmp24_pointGrain(img), bmp24_toPlanarTask, &task);
+    return planar;
+}
+
+/*
+Réécrit les pixels d'une image 24 bits à partir de trois plans de mêmes dimensions
+*/
+void bmp24_fromPlanar(t_bmp24 *img, const t_bmp24_planar *planar) {
+    if (img == NULL || img->pixels == NULL || planar == NULL) {
+        printf("Erreur : image invalide pour bmp24_fromPlanar.\n");
+        return;
+    }
+    const t_bmp8 *planes[3] = {&planar->blue, &planar->green, &planar->red};
+    for (int c = 0; c < 3; c++) {
+        if (planes[c]->data == NULL || planes[c]->width != (unsigned int)img->width
+            || planes[c]->height != (unsigned int)img->height) {
+            printf("Erreur : dimensions des plans differentes de l image\n");
+            return;
+        }
+    }
+
+    t_bmp24_planarTask task = {img, (t_bmp24_planar *)planar};
+    parallel_for(img->height, bmp24_pointGrain(img), bmp24_fromPlanarTask, &task);
+}
+
+/*
+Libère les trois plans et la structure
+*/
+void bmp24_freePlanar(t_bmp24_planar *planar) {
+    if (planar == NULL) return;
+    memory_free(planar->blue.data);
+    memory_free(planar->green.data);
+    memory_free(planar->red.data);
+    bmp8_releaseScratch(&planar->blue);
+    bmp8_releaseScratch(&planar->green);
+    bmp8_releaseScratch(&planar->red);
+    memory_free(planar);
+}
+
+/*
+Applique un noyau à chacun des trois plans (chemins bmp8_applyKernel)
+*/
+void bmp24_planarApplyKernel(t_bmp24_planar *planar, const t_kernel *kernel) {
+    if (planar == NULL) return;
+    bmp8_applyKernel(&planar->blue, kernel);
+    bmp8_applyKernel(&planar->green, kernel);
+    bmp8_applyKernel(&planar->red, kernel);
+}
+
+/*
+Égalise chaque plan indépendamment (histogramme et CDF propres à la composante)
+- Contrairement à bmp24_equalize, qui n'égalise que la luminance, les teintes peuvent changer
+*/
+void bmp24_planarEqualize(t_bmp24_planar *planar) {
+    if (planar == NULL) return;
+    t_bmp8 *planes[3] = {&planar->blue, &planar->green, &planar->red};
+    for (int c = 0; c < 3; c++) {
+        unsigned int *hist = bmp8_computeHistogram(planes[c]);
+        if (!hist) return;
+        unsigned int *cdf = bmp8_computeCDF(hist, planes[c]->dataSize);
+        free(hist);
+        if (!cdf) return;
+        bmp8_equalize(planes[c], cdf);
+        free(cdf);
+    }
+}
+
+static void bmp24_planarGrayscaleTask(void *arg, int start, int stop, int worker) {
+    t_bmp24_planar *planar = arg;
+    (void)worker;
+    size_t width = planar->blue.width;
+    for (int y = start; y < stop; y++) {
+        size_t offset = (size_t)y * width;
+        uint8_t *blue = planar->blue.data + offset;
+        simd_average3(blue, planar->green.data + offset, planar->red.data + offset, blue, width);
+        memcpy(planar->green.data + offset, blue, width);
+        memcpy(planar->red.data + offset, blue, width);
+    }
+}
+
+/*
+Niveaux de gris sur les plans : même moyenne que bmp24_grayscale,
+calculée sur des plans alignés (aucun réarrangement des octets)
+*/
+void bmp24_planarGrayscale(t_bmp24_planar *planar) {
+    if (planar == NULL) return;
+    int grain = (int)(65536 / (planar->blue.width + 1)) + 1;
+    parallel_for((int)planar->blue.height, grain, bmp24_planarGrayscaleTask, planar);
 }
@@ -1,8 +1,11 @@
 #ifndef BMP24_H
 #define BMP24_H
 
+#include <stddef.h>
 #include <stdint.h>
 #include <stdio.h>
+#include "filtres.h"
+#include "bmp8.h"
 
 
 // Offsets dans l’en-tête BMP
@@ -13,6 +16,13 @@
 #define BITMAP_HEIGHT  0x16  // offset 22
 #define BITMAP_DEPTH   0x1C  // offset 28
 #define BITMAP_SIZE_RAW 0x22 // offset 34
+#define BITMAP_COMPRESSION 0x1E // offset 30
+#define BITMAP_MASKS   0x36  // offset 54 : masques rouge, vert, bleu (compression BMP_BI_BITFIELDS)
+
+// Compression des fichiers 24 / 32 bits : pixels bruts, ou masques des composantes
+#define BMP_BI_RGB 0
+#define BMP_BI_BITFIELDS 3
+#define BMP_BI_ALPHABITFIELDS 6
 
 // Type de fichier BMP
 #define BMP_TYPE 0x4D42      // 'BM' en hexadécimal
@@ -24,15 +34,21 @@
 // Profondeur par défaut
 #define DEFAULT_DEPTH 24
 
+// Alignement du buffer de pixels (taille d'une ligne de cache)
+#define BMP24_ALIGNMENT 64
+
 
 // Structure pour un pixel RGB (24 bits)
+// Les composantes sont rangées dans l'ordre du fichier BMP (B, G, R) :
+// une ligne en mémoire a exactement le même format qu'une ligne du fichier
 typedef struct {
-    uint8_t red;
-    uint8_t green;
     uint8_t blue;
+    uint8_t green;
+    uint8_t red;
 } t_pixel;
 
-// En-tête BMP (14 octets)
+// En-tête BMP (14 octets, sans octets de bourrage entre les champs)
+#pragma pack(push, 1)
 typedef struct {
     uint16_t type;
     uint32_t size;
@@ -40,6 +56,7 @@ typedef struct {
     uint16_t reserved2;
     uint32_t offset;
 } t_bmp_header;
+#pragma pack(pop)
 
 // Informations de l'image BMP (40 octets)
 typedef struct {
@@ -57,6 +74,15 @@ typedef struct {
 } t_bmp_info;
 
 // Structure principale pour une image 24 bits
+// - pixels  : un seul buffer contigu, aligné sur BMP24_ALIGNMENT
+// - stride  : écart en octets entre le début de deux lignes consécutives
+//             (négatif pour une vue projetée, les lignes BMP étant stockées de bas en haut)
+// - data    : vues sur les lignes (data[y] pointe dans pixels), pour garder l'accès data[y][x]
+// - mapping : non NULL si les pixels sont une vue sur le fichier projeté en mémoire
+// - scratch : buffer de travail des filtres (copie agrandie, buffers par thread), gardé entre
+//   deux traitements et agrandi au besoin ; libéré par bmp24_free ou bmp24_releaseScratch
+// - alpha   : images 32 bits (colorDepth = 32) : 4e octet de chaque pixel (width x height,
+//   ligne 0 en haut), NULL sinon ; les pixels restent en BGR, les filtres ne touchent pas alpha
 typedef struct {
     t_bmp_header header;
     t_bmp_info header_info;
@@ -64,38 +90,85 @@ typedef struct {
     int height;
     int colorDepth;
     t_pixel **data;
+    t_pixel *pixels;
+    int stride;
+    void *mapping;
+    size_t mappingSize;
+    void *scratch;
+    size_t scratchSize;
+    uint8_t *alpha;
 } t_bmp24;
 
+// Accès direct à la ligne y via le stride (sans passer par data)
+static inline t_pixel *bmp24_row(const t_bmp24 *img, int y) {
+    return (t_pixel *)((uint8_t *)img->pixels + (ptrdiff_t)y * img->stride);
+}
+
 // Fonctions de base
+int bmp24_computeStride(int width);
 t_pixel **bmp24_allocateDataPixels(int width, int height);
 void bmp24_freeDataPixels(t_pixel **pixels, int height);
 t_bmp24 *bmp24_allocate(int width, int height, int colorDepth);
 void bmp24_free(t_bmp24 *img);
+void bmp24_releaseScratch(t_bmp24 *img);
 t_bmp24 *bmp24_loadImage(const char *filename);
+t_bmp24 *bmp24_loadImageMapped(const char *filename);
+void bmp24_copyPixels(t_bmp24 *dst, const t_bmp24 *src);
 
 
 
 
 void bmp24_readPixelValue(t_bmp24 *image, int x, int y, FILE *file);
-void bmp24_readPixelData(t_bmp24 *image, FILE *file);
+int bmp24_readPixelData(t_bmp24 *image, FILE *file);
 void bmp24_writePixelValue(t_bmp24 *image, int x, int y, FILE *file);
-void bmp24_writePixelData(t_bmp24 *image, FILE *file);
+int bmp24_writePixelData(t_bmp24 *image, FILE *file);
 
 
-void bmp24_saveImage(t_bmp24 *img, const char *filename);
+// bmp24_saveImage retourne 0, ou -1 si le fichier n'a pas pu être écrit
+int bmp24_saveImage(t_bmp24 *img, const char *filename);
 
 
 void bmp24_negative(t_bmp24 *img);
 void bmp24_grayscale(t_bmp24 *img);
 void bmp24_brightness(t_bmp24 *img, int value);
+void bmp24_gamma(t_bmp24 *img, float gamma);
+void bmp24_levels(t_bmp24 *img, int inBlack, int inWhite, float gamma, int outBlack, int outWhite);
+
+// Tables de correspondance par composante (nouvelle valeur = table[valeur])
+// Les fonctions bmp24_lut* composent leur courbe avec les tables existantes :
+// plusieurs réglages se cumulent et s'appliquent en une seule passe (bmp24_applyLut)
+#define BMP24_CHANNEL_BLUE  1
+#define BMP24_CHANNEL_GREEN 2
+#define BMP24_CHANNEL_RED   4
+#define BMP24_CHANNEL_ALL   7
+
+typedef struct {
+    uint8_t blue[256];
+    uint8_t green[256];
+    uint8_t red[256];
+} t_bmp24_lut;
+
+void bmp24_lutInit(t_bmp24_lut *lut);
+void bmp24_lutNegative(t_bmp24_lut *lut);
+void bmp24_lutBrightness(t_bmp24_lut *lut, int value);
+void bmp24_lutGamma(t_bmp24_lut *lut, float gamma);
+void bmp24_lutLevels(t_bmp24_lut *lut, int inBlack, int inWhite, float gamma, int outBlack, int outWhite);
+void bmp24_lutCurve(t_bmp24_lut *lut, int channels, const uint8_t curve[256]);
+void bmp24_applyLut(t_bmp24 *img, const t_bmp24_lut *lut);
 
 t_pixel bmp24_convolution(t_bmp24 *img, int x, int y, float **kernel, int kernelSize);
+t_pixel bmp24_convolutionInt(t_bmp24 *img, int x, int y, const int32_t *weights, int kernelSize,
+                             const t_kernelDivider *divider);
+void bmp24_applyKernel(t_bmp24 *img, const t_kernel *kernel);
+void bmp24_applyFilter(t_bmp24 *img, float **kernel, int kernelSize);
 
 void bmp24_boxBlur(t_bmp24 *img);
+void bmp24_boxBlurRadius(t_bmp24 *img, int radius);
 float **createBoxBlurKernel();
 void freeKernel(float **kernel);
 
 void bmp24_gaussianBlur(t_bmp24 *img);
+int bmp24_gaussianBlurSigma(t_bmp24 *img, float sigma);
 float **createGaussianBlurKernel();
 
 void bmp24_outline(t_bmp24 *img);
@@ -107,8 +180,43 @@ float **createEmbossKernel();
 void bmp24_sharpen(t_bmp24 *img);
 float **createSharpenKernel();
 
+// Filtre par bandes : lit, filtre et écrit le fichier bande par bande
+// (mémoire proportionnelle à bandHeight, pas à la taille de l'image)
+#define BMP24_DEFAULT_BAND_HEIGHT 256
+int bmp24_applyKernelStreamed(const char *inputFile, const char *outputFile,
+                              const t_kernel *kernel, int bandHeight);
+int bmp24_applyFilterStreamed(const char *inputFile, const char *outputFile,
+                              float **kernel, int kernelSize, int bandHeight);
+
+
+// Histogrammes : composantes (bleu, vert, rouge : 3 x 256 compteurs) et luminance (256 compteurs)
+unsigned int *bmp24_computeHistograms(t_bmp24 *img);
+unsigned int *bmp24_computeLumaHistogram(t_bmp24 *img);
 
 void bmp24_equalize(t_bmp24 *img);
+// Égalisation adaptative à contraste limité (CLAHE) de la luminance, voir bmp8_clahe
+void bmp24_clahe(t_bmp24 *img, int tilesX, int tilesY, float clipLimit);
+
+// Représentation planaire : une image 8 bits par composante (bleu, vert, rouge)
+// - chaque plan est un t_bmp8 complet (pixels contigus, en-tête et palette de gris, lignes
+//   dans l'ordre du fichier BMP) : les fonctions bmp8_* s'y appliquent telles quelles
+//   (filtres, chaîne de traitements, égalisation) et bmp8_saveImage enregistre un plan
+// - les filtres 8 et 24 bits ont les mêmes bords (voir borderSet) : pour un noyau symétrique
+//   haut / bas, bmp24_planarApplyKernel donne le même résultat que bmp24_applyKernel
+//   (à l'arrondi flottant près ; les plans sont rangés de bas en haut)
+typedef struct {
+    t_bmp8 blue;
+    t_bmp8 green;
+    t_bmp8 red;
+} t_bmp24_planar;
+
+t_bmp24_planar *bmp24_toPlanar(const t_bmp24 *img);
+void bmp24_fromPlanar(t_bmp24 *img, const t_bmp24_planar *planar);
+void bmp24_freePlanar(t_bmp24_planar *planar);
+// Traitements appliqués aux trois plans
+void bmp24_planarApplyKernel(t_bmp24_planar *planar, const t_kernel *kernel);
+void bmp24_planarEqualize(t_bmp24_planar *planar);
+void bmp24_planarGrayscale(t_bmp24_planar *planar);
 
 
 #endif
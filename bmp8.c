@@ -1,7 +1,12 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include "bmp8.h"
 #include "filtres.h"
+#include "mapping.h"
+#include "simd.h"
+#include "parallele.h"
+#include "memoire.h"
 
 /*
 Fonction pour charger une image BMP 8 bits (niveaux de gris)
@@ -18,12 +23,16 @@ t_bmp8* bmp8_loadImage(const char *filename) {
         return NULL;
     }
 
-    t_bmp8 *image = (t_bmp8 *)malloc(sizeof(t_bmp8));
+    t_bmp8 *image = (t_bmp8 *)memory_alloc(sizeof(t_bmp8));
     if (!image) {
         printf("Erreur : echec de l allocation memoire\n");
         fclose(file);
         return NULL;
     }
+    image->mapping = NULL;
+    image->mappingSize = 0;
+    image->scratch = NULL;
+    image->scratchSize = 0;
 
     // Lire le header (54 octets)
     fread(image->header, sizeof(unsigned char), 54, file);
@@ -40,16 +49,16 @@ t_bmp8* bmp8_loadImage(const char *filename) {
     // Vérification profondeur de couleur
     if (image->colorDepth != 8) {
         printf("Erreur : image non 8 bits (profondeur = %u)\n", image->colorDepth);
-        free(image);
+        memory_free(image);
         fclose(file);
         return NULL;
     }
 
     // Allocation mémoire pour les pixels
-    image->data = (unsigned char *)malloc(image->dataSize);
+    image->data = (unsigned char *)memory_alloc(image->dataSize);
     if (!image->data) {
         printf("Erreur : echec allocation memoire des pixels\n");
-        free(image);
+        memory_free(image);
         fclose(file);
         return NULL;
     }
@@ -61,46 +70,126 @@ t_bmp8* bmp8_loadImage(const char *filename) {
     return image;
 }
 
+/*
+Charge une image BMP 8 bits par projection mémoire (sans copie des pixels)
+- data pointe directement dans le fichier projeté, à l'offset des pixels
+- Les pages ne sont lues qu'au premier accès : idéal pour infos, histogramme...
+- Les modifications restent en mémoire (copie à l'écriture), le fichier n'est pas touché
+- Si la projection est impossible, se rabat sur bmp8_loadImage
+*/
+t_bmp8* bmp8_loadImageMapped(const char *filename) {
+    size_t size = 0;
+    unsigned char *map = mapping_open(filename, &size);
+    if (!map) return bmp8_loadImage(filename);
+
+    if (size < 54 + 1024) {
+        printf("Erreur : fichier %s trop petit\n", filename);
+        mapping_close(map, size);
+        return NULL;
+    }
+
+    t_bmp8 *image = (t_bmp8 *)memory_alloc(sizeof(t_bmp8));
+    if (!image) {
+        printf("Erreur : echec de l allocation memoire\n");
+        mapping_close(map, size);
+        return NULL;
+    }
+
+    memcpy(image->header, map, 54);
+    memcpy(image->colorTable, map + 54, 1024);
+    image->scratch = NULL;
+    image->scratchSize = 0;
+
+    // Métadonnées lues par memcpy (le header projeté n'est pas aligné)
+    unsigned int offset;
+    unsigned short depth;
+    memcpy(&offset, &image->header[10], sizeof(offset));
+    memcpy(&image->width, &image->header[18], sizeof(image->width));
+    memcpy(&image->height, &image->header[22], sizeof(image->height));
+    memcpy(&depth, &image->header[28], sizeof(depth));
+    image->colorDepth  = depth;
+    image->dataSize    = image->width * image->height;
+
+    if (image->colorDepth != 8) {
+        printf("Erreur : image non 8 bits (profondeur = %u)\n", image->colorDepth);
+        memory_free(image);
+        mapping_close(map, size);
+        return NULL;
+    }
+
+    if (offset > size || size - offset < image->dataSize) {
+        printf("Erreur : donnees pixels incompletes dans %s\n", filename);
+        memory_free(image);
+        mapping_close(map, size);
+        return NULL;
+    }
+
+    image->data = map + offset;
+    image->mapping = map;
+    image->mappingSize = size;
+    return image;
+}
+
+/*
+Libère le buffer de pixels d'une image, qu'il soit alloué ou projeté
+*/
+static void bmp8_releaseData(t_bmp8 *img) {
+    if (img->mapping != NULL) {
+        mapping_close(img->mapping, img->mappingSize);
+        img->mapping = NULL;
+        img->mappingSize = 0;
+    } else {
+        memory_free(img->data);
+    }
+    img->data = NULL;
+}
+
 /*
 Sauvegarde une image BMP 8 bits
 - Ouvre le fichier en écriture
 - Écrit l'en-tête, la table des couleurs et les données
+- Retourne 0, ou -1 si le fichier n'a pas pu être ouvert, écrit ou fermé
 */
-void bmp8_saveImage(const char *filename, t_bmp8 *img) {
+int bmp8_saveImage(const char *filename, t_bmp8 *img) {
     if (!img) {
         printf("Erreur : image invalide (NULL)\n");
-        return;
+        return -1;
     }
 
     FILE *file = fopen(filename, "wb");
     if (!file) {
         printf("Erreur : impossible d ouvrir le fichier %s en ecriture\n", filename);
-        return;
+        return -1;
     }
 
     // Écrire le header (54 octets)
     if (fwrite(img->header, sizeof(unsigned char), 54, file) != 54) {
         printf("Erreur lors de l ecriture du header\n");
         fclose(file);
-        return;
+        return -1;
     }
 
     // Écrire la table des couleurs (1024 octets)
     if (fwrite(img->colorTable, sizeof(unsigned char), 1024, file) != 1024) {
         printf("Erreur lors de l ecriture de la table de couleurs\n");
         fclose(file);
-        return;
+        return -1;
     }
 
     // Écrire les données image (pixels)
     if (fwrite(img->data, sizeof(unsigned char), img->dataSize, file) != img->dataSize) {
         printf("Erreur lors de l ecriture des pixels\n");
         fclose(file);
-        return;
+        return -1;
     }
 
-    fclose(file);
+    // fclose vide le tampon : une erreur d'écriture (disque plein) peut n'apparaître qu'ici
+    if (fclose(file) != 0) {
+        printf("Erreur lors de l ecriture de %s\n", filename);
+        return -1;
+    }
     printf("Image sauvegardee dans %s \n", filename);
+    return 0;
 }
 
 /*
@@ -109,12 +198,38 @@ Libère la mémoire allouée pour une image BMP 8 bits
 void bmp8_free(t_bmp8 *img) {
     if (img != NULL) {
         if (img->data != NULL) {
-            free(img->data);  // Libère les pixels
+            bmp8_releaseData(img);  // Libère les pixels (ou la projection)
         }
-        free(img);  // Libère la structure entière
+        bmp8_releaseScratch(img);
+        memory_free(img);  // Libère la structure entière
     }
 }
 
+/*
+Libère le buffer de travail des filtres (il sera réalloué au prochain filtre)
+- Utile pour rendre la mémoire d'une image gardée longtemps sans nouveau traitement
+*/
+void bmp8_releaseScratch(t_bmp8 *img) {
+    if (img == NULL) return;
+    memory_free(img->scratch);
+    img->scratch = NULL;
+    img->scratchSize = 0;
+}
+
+/*
+Buffer de travail d'au moins size octets, gardé par l'image entre deux filtres
+- Réutilisé s'il est assez grand, sinon remplacé (l'ancien contenu n'est pas conservé) :
+  une suite de filtres n'alloue qu'au premier, ou quand il lui faut plus de place
+*/
+static void *bmp8_scratch(t_bmp8 *img, size_t size) {
+    if (img->scratchSize < size) {
+        memory_free(img->scratch);
+        img->scratch = memory_alloc(size);
+        img->scratchSize = img->scratch ? size : 0;
+    }
+    return img->scratch;
+}
+
 /*
 Affiche les informations de base d'une image BMP 8 bits
 */
@@ -131,6 +246,38 @@ void bmp8_printInfo(t_bmp8 *img) {
     printf("Data Size: %u\n", img->dataSize);
 }
 
+/*
+Contexte des traitements point à point (une tuile = un groupe de lignes)
+*/
+typedef struct {
+    unsigned char *data;
+    unsigned int width;
+    int value;
+} t_bmp8_pointTask;
+
+// Nombre minimal de lignes par tuile pour les traitements point à point (~64 Ko)
+static int bmp8_pointGrain(const t_bmp8 *img) {
+    return (int)(65536 / (img->width ? img->width : 1)) + 1;
+}
+
+static void bmp8_negativeTask(void *arg, int start, int stop, int worker) {
+    t_bmp8_pointTask *t = arg;
+    (void)worker;
+    simd_negate(t->data + (size_t)start * t->width, (size_t)(stop - start) * t->width);
+}
+
+static void bmp8_brightnessTask(void *arg, int start, int stop, int worker) {
+    t_bmp8_pointTask *t = arg;
+    (void)worker;
+    simd_addSaturate(t->data + (size_t)start * t->width, (size_t)(stop - start) * t->width, t->value);
+}
+
+static void bmp8_thresholdTask(void *arg, int start, int stop, int worker) {
+    t_bmp8_pointTask *t = arg;
+    (void)worker;
+    simd_threshold(t->data + (size_t)start * t->width, (size_t)(stop - start) * t->width, t->value);
+}
+
 /*
 - Applique un effet négatif à l'image
 - Inverse chaque valeur de pixel (255 - valeur)
@@ -141,9 +288,9 @@ void bmp8_negative(t_bmp8 *img) {
         return;
     }
 
-    for (unsigned int i = 0; i < img->dataSize; i++) {
-        img->data[i] = 255 - img->data[i];  // Inversion du pixel
-    }
+    // Inversion des pixels (SSE2/AVX2 si disponible), lignes réparties sur les threads
+    t_bmp8_pointTask task = {img->data, img->width, 0};
+    parallel_for((int)img->height, bmp8_pointGrain(img), bmp8_negativeTask, &task);
 
     printf("Effet negatif applique \n");
 }
@@ -159,14 +306,9 @@ void bmp8_brightness(t_bmp8 *img, int value) {
         return;
     }
 
-    for (unsigned int i = 0; i < img->dataSize; i++) {
-        int pixel = img->data[i] + value;
-
-        if (pixel > 255) pixel = 255;
-        if (pixel < 0) pixel = 0;
-
-        img->data[i] = (unsigned char)pixel;
-    }
+    // Addition saturée : le clamp est fait par l'instruction, sans test par pixel
+    t_bmp8_pointTask task = {img->data, img->width, value};
+    parallel_for((int)img->height, bmp8_pointGrain(img), bmp8_brightnessTask, &task);
 
     printf("Luminosite ajustee (value = %d) \n", value);
 }
@@ -182,82 +324,870 @@ void bmp8_threshold(t_bmp8 *img, int threshold) {
         return;
     }
 
-    for (unsigned int i = 0; i < img->dataSize; i++) {
-        img->data[i] = (img->data[i] >= threshold) ? 255 : 0;
-    }
+    t_bmp8_pointTask task = {img->data, img->width, threshold};
+    parallel_for((int)img->height, bmp8_pointGrain(img), bmp8_thresholdTask, &task);
 
     printf("Seuil applique (threshold = %d) \n", threshold);
 }
 
 /*
-Applique un filtre de convolution à l'image
-- Crée une copie des données pour éviter les effets de bord
-- Applique le noyau de convolution à chaque pixel
+Initialise une chaîne vide (table identité)
+*/
+void bmp8_chainInit(t_bmp8_chain *chain) {
+    for (int i = 0; i < 256; i++) {
+        chain->lut[i] = (unsigned char)i;
+    }
+    chain->stepCount = 0;
+    chain->lutOnly = 0;
+}
+
+/*
+Ajoute une étape à la chaîne
+- La table est composée tout de suite : lut[i] = étape(lut[i])
+- Les mêmes formules que bmp8_negative, bmp8_brightness et bmp8_threshold
+*/
+static void bmp8_chainAddStep(t_bmp8_chain *chain, t_bmp8_stepType type, int value) {
+    for (int i = 0; i < 256; i++) {
+        int v = chain->lut[i];
+        switch (type) {
+            case BMP8_STEP_NEGATIVE: v = 255 - v; break;
+            case BMP8_STEP_BRIGHTNESS: v += value; break;
+            case BMP8_STEP_THRESHOLD: v = (v >= value) ? 255 : 0; break;
+        }
+        chain->lut[i] = (unsigned char)(v < 0 ? 0 : (v > 255 ? 255 : v));
+    }
+
+    if (chain->stepCount < BMP8_CHAIN_MAX_STEPS) {
+        chain->steps[chain->stepCount].type = type;
+        chain->steps[chain->stepCount].value = value;
+        chain->stepCount++;
+    } else {
+        chain->lutOnly = 1;
+    }
+}
+
+void bmp8_chainNegative(t_bmp8_chain *chain) {
+    bmp8_chainAddStep(chain, BMP8_STEP_NEGATIVE, 0);
+}
+
+void bmp8_chainBrightness(t_bmp8_chain *chain, int value) {
+    bmp8_chainAddStep(chain, BMP8_STEP_BRIGHTNESS, value);
+}
+
+void bmp8_chainThreshold(t_bmp8_chain *chain, int threshold) {
+    bmp8_chainAddStep(chain, BMP8_STEP_THRESHOLD, threshold);
+}
+
+/*
+Ajoute une courbe quelconque (nouvelle valeur = curve[valeur])
+- Pas d'équivalent SIMD : la chaîne passe par la table seule
+*/
+void bmp8_chainCurve(t_bmp8_chain *chain, const unsigned char curve[256]) {
+    for (int i = 0; i < 256; i++) {
+        chain->lut[i] = curve[chain->lut[i]];
+    }
+    chain->lutOnly = 1;
+}
+
+// Taille d'un bloc de la chaîne : reste dans le cache L1/L2 entre deux étapes
+#define BMP8_CHAIN_BLOCK 16384
+
+typedef struct {
+    unsigned char *data;
+    unsigned int width;
+    const t_bmp8_chain *chain;
+} t_bmp8_chainTask;
+
+static void bmp8_chainTask(void *arg, int start, int stop, int worker) {
+    t_bmp8_chainTask *t = arg;
+    const t_bmp8_chain *chain = t->chain;
+    unsigned char *data = t->data + (size_t)start * t->width;
+    size_t n = (size_t)(stop - start) * t->width;
+    (void)worker;
+
+    if (chain->lutOnly) {
+        const unsigned char *lut = chain->lut;
+        for (size_t i = 0; i < n; i++) {
+            data[i] = lut[data[i]];
+        }
+        return;
+    }
+
+    // Chaque bloc est lu une fois en mémoire, les étapes s'enchaînent dans le cache
+    for (size_t pos = 0; pos < n; pos += BMP8_CHAIN_BLOCK) {
+        unsigned char *block = data + pos;
+        size_t count = n - pos < BMP8_CHAIN_BLOCK ? n - pos : BMP8_CHAIN_BLOCK;
+        for (int s = 0; s < chain->stepCount; s++) {
+            const t_bmp8_step *step = &chain->steps[s];
+            switch (step->type) {
+                case BMP8_STEP_NEGATIVE: simd_negate(block, count); break;
+                case BMP8_STEP_BRIGHTNESS: simd_addSaturate(block, count, step->value); break;
+                case BMP8_STEP_THRESHOLD: simd_threshold(block, count, step->value); break;
+            }
+        }
+    }
+}
+
+/*
+Applique une chaîne de traitements point à point en une seule passe
+- Chaque pixel n'est lu et écrit qu'une fois en mémoire, quel que soit le nombre d'étapes
+- Chaîne courte : étapes SIMD rejouées par blocs de 16 Ko (plus rapide qu'une table,
+  qui coûte une lecture indexée par pixel)
+- Courbe ou plus de BMP8_CHAIN_MAX_STEPS étapes : table composée
+- Résultat identique à l'appel des fonctions une par une
+*/
+void bmp8_chainApply(t_bmp8 *img, const t_bmp8_chain *chain) {
+    if (img == NULL || img->data == NULL || chain == NULL) {
+        printf("Erreur : image invalide pour bmp8_chainApply.\n");
+        return;
+    }
+    if (!chain->lutOnly && chain->stepCount == 0) return;
+
+    t_bmp8_chainTask task = {img->data, img->width, chain};
+    parallel_for((int)img->height, bmp8_pointGrain(img), bmp8_chainTask, &task);
+
+    printf("Chaine de traitements appliquee\n");
+}
+
+// Nombre minimal de lignes par tuile pour les convolutions
+#define BMP8_FILTER_GRAIN 8
+
+/*
+Contexte de la copie agrandie d'une image (voir bmp8_padImage)
+*/
+typedef struct {
+    const t_bmp8 *img;
+    unsigned char *padded;
+    size_t stride;
+    int radius;
+    t_border border;
+} t_bmp8_padTask;
+
+static void bmp8_padTask(void *arg, int start, int stop, int worker) {
+    t_bmp8_padTask *t = arg;
+    int width = (int)t->img->width;
+    (void)worker;
+    for (int py = start; py < stop; py++) {
+        int y = borderIndex(&t->border, py - t->radius, (int)t->img->height);
+        const unsigned char *src = (y < 0) ? NULL : t->img->data + (size_t)y * width;
+        borderPadRow(&t->border, src, t->padded + (size_t)py * t->stride, width, t->radius, 1);
+    }
+}
+
+/*
+Copie l'image dans un buffer agrandi de radius pixels de chaque côté
+- Halo rempli selon le mode de bord courant (voir borderSet), lignes réparties sur le pool
+- stride : largeur du buffer (width + 2 radius)
+- Copie et zone *extra (extra octets, buffers par thread) sont prises dans le buffer de travail
+  de l'image (voir bmp8_scratch) : rien à libérer
+- Retourne le buffer, dont le pixel (0, 0) de l'image est en radius * stride + radius, ou NULL
+*/
+static unsigned char *bmp8_padImage(t_bmp8 *img, int radius, size_t *stride, size_t extra, void **extraArea) {
+    t_bmp8_padTask task;
+    task.img = img;
+    task.stride = (size_t)img->width + 2 * (size_t)radius;
+    task.radius = radius;
+    task.border = borderGet();
+    size_t padSize = task.stride * ((size_t)img->height + 2 * (size_t)radius);
+    padSize = (padSize + 63) & ~(size_t)63;  // zone extra alignée pour les float / int32
+    task.padded = bmp8_scratch(img, padSize + extra);
+    if (!task.padded) return NULL;
+
+    parallel_for((int)img->height + 2 * radius, BMP8_FILTER_GRAIN, bmp8_padTask, &task);
+    *stride = task.stride;
+    if (extraArea) *extraArea = task.padded + padSize;
+    return task.padded;
+}
+
+/*
+Contexte partagé par les tâches de convolution
+- src / stride : pixel (0, 0) de la copie agrandie de l'image (voir bmp8_padImage) ;
+  tous les voisins y sont présents, les boucles de calcul ne testent pas les bords
+- Une tuile = un groupe de lignes, écrites directement dans img->data (les lectures se font
+  dans la copie) : résultat identique quel que soit le nombre de threads
+*/
+typedef struct {
+    t_bmp8 *img;
+    const unsigned char *src;
+    size_t stride;
+    const t_kernel *kernel;
+    t_kernelDivider divider;    // chemins entiers
+    void *scratch;              // anneau + accumulateur (float ou int32), un bloc par thread
+    size_t scratchCount;
+} t_bmp8_filterTask;
+
+/*
+Passe séparable (horizontale puis verticale) sur les lignes d'une tuile
+- rowKernel / colKernel : décomposition du noyau (voir separateKernel)
+- 2K multiplications par pixel au lieu de K²
+- Les résultats horizontaux sont gardés dans un anneau de K lignes, propre au thread
+*/
+static void bmp8_separableTask(void *arg, int start, int stop, int worker) {
+    t_bmp8_filterTask *t = arg;
+    int offset = t->kernel->radius;
+    int kernelSize = t->kernel->size;
+    int width = (int)t->img->width;
+    const float *rowKernel = t->kernel->rowKernel;
+    const float *colKernel = t->kernel->colKernel;
+
+    float *ring = (float *)t->scratch + (size_t)worker * t->scratchCount;
+    float *acc = ring + (size_t)kernelSize * width;
+
+    int next = start - offset;  // prochaine ligne à filtrer horizontalement (halo de la tuile compris)
+    for (int y = start; y < stop; y++) {
+        // Passe horizontale des lignes manquantes
+        while (next <= y + offset) {
+            const unsigned char *src = t->src + (ptrdiff_t)next * (ptrdiff_t)t->stride;
+            float *dst = ring + (size_t)((next + offset) % kernelSize) * width;
+            for (int x = 0; x < width; x++) {
+                float sum = 0.0f;
+                for (int j = -offset; j <= offset; j++) {
+                    sum += src[x + j] * rowKernel[j + offset];
+                }
+                dst[x] = sum;
+            }
+            next++;
+        }
+
+        // Passe verticale sur les K lignes de l'anneau
+        for (int x = 0; x < width; x++) acc[x] = 0.0f;
+        for (int i = -offset; i <= offset; i++) {
+            const float *src = ring + (size_t)((y + i + offset) % kernelSize) * width;
+            float coef = colKernel[i + offset];
+            for (int x = 0; x < width; x++) {
+                acc[x] += src[x] * coef;
+            }
+        }
+
+        unsigned char *dst = t->img->data + (size_t)y * width;
+        for (int x = 0; x < width; x++) {
+            int value = (int)(acc[x] + 0.5f);
+            if (value < 0) value = 0;
+            if (value > 255) value = 255;
+            dst[x] = (unsigned char)value;
+        }
+    }
+}
+
+/*
+Passe séparable entière : même parcours que bmp8_separableTask, sommes exactes sur 32 bits
+- intRow / intCol : facteurs entiers, division arrondie par leur produit à la fin
+- Noyau symétrique : les pixels à égale distance du centre sont additionnés avant la
+  multiplication (K/2 + 1 multiplications par pixel au lieu de K)
+*/
+static void bmp8_separableIntTask(void *arg, int start, int stop, int worker) {
+    t_bmp8_filterTask *t = arg;
+    int offset = t->kernel->radius;
+    int kernelSize = t->kernel->size;
+    int width = (int)t->img->width;
+    const int32_t *intRow = t->kernel->intRow;
+    const int32_t *intCol = t->kernel->intCol;
+    int symmetric = t->kernel->symmetric;
+
+    int32_t *ring = (int32_t *)t->scratch + (size_t)worker * t->scratchCount;
+    int32_t *acc = ring + (size_t)kernelSize * width;
+
+    int next = start - offset;
+    for (int y = start; y < stop; y++) {
+        while (next <= y + offset) {
+            const unsigned char *src = t->src + (ptrdiff_t)next * (ptrdiff_t)t->stride;
+            int32_t *dst = ring + (size_t)((next + offset) % kernelSize) * width;
+            for (int x = 0; x < width; x++) {
+                int32_t sum;
+                if (symmetric) {
+                    sum = src[x] * intRow[offset];
+                    for (int j = 1; j <= offset; j++) {
+                        sum += (src[x - j] + src[x + j]) * intRow[offset + j];
+                    }
+                } else {
+                    sum = 0;
+                    for (int j = -offset; j <= offset; j++) {
+                        sum += src[x + j] * intRow[j + offset];
+                    }
+                }
+                dst[x] = sum;
+            }
+            next++;
+        }
+
+        for (int x = 0; x < width; x++) acc[x] = 0;
+        for (int i = -offset; i <= offset; i++) {
+            const int32_t *src = ring + (size_t)((y + i + offset) % kernelSize) * width;
+            int32_t coef = intCol[i + offset];
+            for (int x = 0; x < width; x++) {
+                acc[x] += src[x] * coef;
+            }
+        }
+
+        unsigned char *dst = t->img->data + (size_t)y * width;
+        for (int x = 0; x < width; x++) {
+            dst[x] = kernelDivide(&t->divider, acc[x]);
+        }
+    }
+}
+
+/*
+Convolution entière d'une ligne sur les coefficients non nuls : somme exacte, puis division arrondie
+- src : pixel 0 de la ligne dans un buffer agrandi d'au moins kernel->radius pixels de chaque côté
+- stride : écart en octets entre deux lignes du buffer (négatif pour des lignes de bas en haut)
+*/
+static void bmp8_convolveRowInt(const t_kernel *kernel, const t_kernelDivider *divider,
+                                const unsigned char *src, ptrdiff_t stride, unsigned char *dst, int width) {
+    const t_kernelTap *taps = kernel->taps;
+    int tapCount = kernel->tapCount;
+    for (int x = 0; x < width; x++) {
+        int32_t sum = 0;
+        for (int k = 0; k < tapCount; k++) {
+            sum += src[(ptrdiff_t)taps[k].dy * stride + x + taps[k].dx] * taps[k].weight;
+        }
+        dst[x] = kernelDivide(divider, sum);
+    }
+}
+
+/*
+Version flottante de bmp8_convolveRowInt (arrondi au plus proche, borné à [0, 255])
+*/
+static void bmp8_convolveRow(const t_kernel *kernel, const unsigned char *src, ptrdiff_t stride,
+                             unsigned char *dst, int width) {
+    const t_kernelTap *taps = kernel->taps;
+    int tapCount = kernel->tapCount;
+    for (int x = 0; x < width; x++) {
+        float sum = 0.0f;
+        for (int k = 0; k < tapCount; k++) {
+            sum += src[(ptrdiff_t)taps[k].dy * stride + x + taps[k].dx] * taps[k].value;
+        }
+
+        // Clamp entre 0 et 255
+        int value = (int)(sum + 0.5f);
+        if (value < 0) value = 0;
+        if (value > 255) value = 255;
+        dst[x] = (unsigned char)value;
+    }
+}
+
+/*
+Noyau complet en entiers : somme exacte sur les coefficients non nuls, puis division arrondie
+*/
+static void bmp8_kernelIntTask(void *arg, int start, int stop, int worker) {
+    t_bmp8_filterTask *t = arg;
+    size_t width = t->img->width;
+    (void)worker;
+    for (int y = start; y < stop; y++) {
+        bmp8_convolveRowInt(t->kernel, &t->divider, t->src + (size_t)y * t->stride, (ptrdiff_t)t->stride,
+                            t->img->data + (size_t)y * width, (int)width);
+    }
+}
+
+/*
+Noyau 3x3 entier sur les lignes d'une tuile (voir simd_convolve3x3)
+- Calcul entier, arrondi au plus proche : résultat exact et reproductible
+- Identique au calcul flottant pour les noyaux fournis (entiers, gaussien, flou moyen)
+*/
+static void bmp8_fixed3x3Task(void *arg, int start, int stop, int worker) {
+    t_bmp8_filterTask *t = arg;
+    size_t width = t->img->width;
+    size_t stride = t->stride;
+    (void)worker;
+
+    for (int y = start; y < stop; y++) {
+        const unsigned char *row = t->src + (size_t)y * stride - 1;
+        simd_convolve3x3(row - stride, row, row + stride, t->img->data + (size_t)y * width,
+                         width, 1, t->kernel->fixed, t->kernel->fixedDivisor);
+    }
+}
+
+/*
+Noyau complet appliqué à chaque pixel des lignes d'une tuile (coefficients non nuls seulement)
+*/
+static void bmp8_kernelTask(void *arg, int start, int stop, int worker) {
+    t_bmp8_filterTask *t = arg;
+    size_t width = t->img->width;
+    (void)worker;
+    for (int y = start; y < stop; y++) {
+        bmp8_convolveRow(t->kernel, t->src + (size_t)y * t->stride, (ptrdiff_t)t->stride,
+                         t->img->data + (size_t)y * width, (int)width);
+    }
+}
+
+/*
+Applique un noyau de convolution à l'image
+- L'image est d'abord copiée avec un halo de kernel->radius pixels (mode de bord : voir borderSet),
+  le résultat est écrit directement dans l'image
+- Le calcul est choisi d'après les métadonnées du noyau :
+  - 3x3 rationnel à poids 16 bits : convolution entière vectorisée, division exacte
+  - séparable et rationnel (flou moyen, gaussien) : deux passes 1D entières
+  - rationnel (entiers / diviseur) : calcul entier exact
+  - séparable : deux passes 1D en flottant
+  - sinon, noyau complet en flottant
+- Les coefficients nuls sont ignorés
 - Clampe les valeurs entre 0 et 255
+- Les lignes sont réparties sur le pool de threads
+*/
+void bmp8_applyKernel(t_bmp8 *img, const t_kernel *kernel) {
+    if (img == NULL || img->data == NULL || kernel == NULL) {
+        printf("Erreur : image invalide pour bmp8_applyFilter.\n");
+        return;
+    }
+
+    int offset = kernel->radius;
+    int separable = kernel->fixedDivisor == 0 && kernel->separable;
+    // Un anneau de K lignes + un accumulateur par thread (float ou int32, 4 octets)
+    size_t scratchCount = separable ? (size_t)(kernel->size + 1) * img->width : 0;
+    size_t stride;
+    void *scratch;
+    unsigned char *padded = bmp8_padImage(img, offset, &stride,
+                                          parallel_getThreadCount() * scratchCount * sizeof(float), &scratch);
+    if (!padded) {
+        printf("Erreur d'allocation mémoire pour le filtre.\n");
+        return;
+    }
+
+    int rows = (int)img->height;
+    t_bmp8_filterTask task;
+    memset(&task, 0, sizeof(task));
+    task.img = img;
+    task.src = padded + (size_t)offset * stride + offset;
+    task.stride = stride;
+    task.kernel = kernel;
+    task.scratch = scratch;
+    task.scratchCount = scratchCount;
+
+    if (kernel->fixedDivisor > 0) {
+        // Noyau 3x3 : calcul entier exact, 16 à 32 pixels par instruction (SSE2/AVX2)
+        parallel_for(rows, BMP8_FILTER_GRAIN, bmp8_fixed3x3Task, &task);
+    } else if (separable && kernel->separableDivisor) {
+        kernelDividerInit(&task.divider, kernel->separableDivisor);
+        parallel_for(rows, BMP8_FILTER_GRAIN, bmp8_separableIntTask, &task);
+    } else if (kernel->divisor) {
+        kernelDividerInit(&task.divider, kernel->divisor);
+        parallel_for(rows, BMP8_FILTER_GRAIN, bmp8_kernelIntTask, &task);
+    } else if (separable) {
+        parallel_for(rows, BMP8_FILTER_GRAIN, bmp8_separableTask, &task);
+    } else {
+        parallel_for(rows, BMP8_FILTER_GRAIN, bmp8_kernelTask, &task);
+    }
+
+    printf("Filtre applique  (kernelSize = %d)\n", kernel->size);
+}
+
+/*
+Applique un filtre de convolution donné sous forme de matrice float **
+- Le noyau est analysé (voir createKernelFromMatrix) puis appliqué par bmp8_applyKernel
 */
 void bmp8_applyFilter(t_bmp8 *img, float **kernel, int kernelSize) {
+    t_kernel *k = createKernelFromMatrix(kernel, kernelSize);
+    if (!k) {
+        printf("Erreur d'allocation mémoire pour le filtre.\n");
+        return;
+    }
+    bmp8_applyKernel(img, k);
+    destroyKernel(k);
+}
+
+/*
+Contexte du flou moyen par sommes glissantes (une tuile = un groupe de lignes)
+- src / stride : copie agrandie de radius pixels (voir bmp8_padImage)
+*/
+typedef struct {
+    t_bmp8 *img;
+    const unsigned char *src;
+    size_t stride;
+    int radius;
+    t_kernelDivider divider;    // division arrondie par (2 radius + 1)²
+    int32_t *scratch;           // sommes de colonnes + 2 lignes de sommes horizontales, par thread
+    size_t scratchCount;
+} t_bmp8_boxTask;
+
+/*
+Sommes horizontales glissantes d'une ligne : sums[x] = src[x - radius] + ... + src[x + radius]
+- src : ligne agrandie (radius pixels de halo de chaque côté), x dans [0, width)
+- Une addition et une soustraction par pixel
+*/
+static void bmp8_boxRowSums(const unsigned char *src, int width, int radius, int32_t *sums) {
+    int32_t sum = 0;
+    for (int x = -radius; x <= radius; x++) sum += src[x];
+    sums[0] = sum;
+    for (int x = 1; x < width; x++) {
+        sum += src[x + radius] - src[x - radius - 1];
+        sums[x] = sum;
+    }
+}
+
+/*
+Flou moyen sur les lignes d'une tuile
+- Les sommes de colonnes sont initialisées sur les 2 radius + 1 lignes autour de la première,
+  puis mises à jour à chaque ligne (ligne entrante ajoutée, ligne sortante retirée)
+- Coût par pixel constant, quel que soit le rayon
+*/
+static void bmp8_boxTask(void *arg, int start, int stop, int worker) {
+    t_bmp8_boxTask *t = arg;
+    int radius = t->radius;
+    int width = (int)t->img->width;
+    ptrdiff_t stride = (ptrdiff_t)t->stride;
+
+    int32_t *cols = t->scratch + (size_t)worker * t->scratchCount;
+    int32_t *incoming = cols + width;
+    int32_t *outgoing = incoming + width;
+
+    for (int x = 0; x < width; x++) cols[x] = 0;
+    for (int i = start - radius; i <= start + radius; i++) {
+        bmp8_boxRowSums(t->src + i * stride, width, radius, incoming);
+        for (int x = 0; x < width; x++) cols[x] += incoming[x];
+    }
+
+    for (int y = start; y < stop; y++) {
+        if (y > start) {
+            bmp8_boxRowSums(t->src + (y + radius) * stride, width, radius, incoming);
+            bmp8_boxRowSums(t->src + (y - radius - 1) * stride, width, radius, outgoing);
+            for (int x = 0; x < width; x++) cols[x] += incoming[x] - outgoing[x];
+        }
+
+        unsigned char *dst = t->img->data + (size_t)y * width;
+        for (int x = 0; x < width; x++) {
+            dst[x] = kernelDivide(&t->divider, cols[x]);
+        }
+    }
+}
+
+/*
+Flou moyen de rayon quelconque ((2 radius + 1)² pixels) par sommes glissantes
+- Même résultat que bmp8_applyKernel avec createBoxKernel(radius) (même halo, sommes entières
+  exactes, arrondi au plus proche), mais coût par pixel indépendant du rayon
+- radius est limité à KERNEL_MAX_BOX_RADIUS
+*/
+void bmp8_boxBlurRadius(t_bmp8 *img, int radius) {
     if (img == NULL || img->data == NULL) {
-        printf("Erreur : image invalide pour bmp8_applyFilter.\n");
+        printf("Erreur : image invalide pour bmp8_boxBlurRadius.\n");
         return;
     }
+    if (radius > KERNEL_MAX_BOX_RADIUS) radius = KERNEL_MAX_BOX_RADIUS;
+    if (radius <= 0 || img->width == 0 || img->height == 0) return;
 
-    int offset = kernelSize / 2;
-    unsigned char *newData = malloc(img->dataSize);
-    if (!newData) {
+    t_bmp8_boxTask task;
+    memset(&task, 0, sizeof(task));
+    task.img = img;
+    task.radius = radius;
+    task.scratchCount = (size_t)3 * img->width;
+    void *scratch;
+    unsigned char *padded = bmp8_padImage(img, radius, &task.stride,
+                                          parallel_getThreadCount() * task.scratchCount * sizeof(int32_t), &scratch);
+    if (!padded) {
         printf("Erreur d'allocation mémoire pour le filtre.\n");
         return;
     }
+    task.scratch = scratch;
+    task.src = padded + (size_t)radius * task.stride + radius;
+    kernelDividerInit(&task.divider, (2 * radius + 1) * (2 * radius + 1));
 
-    // Copie initiale des données (pour garder les bords inchangés)
-    memcpy(newData, img->data, img->dataSize);
+    // Chaque tuile relit 2 radius + 1 lignes pour initialiser ses sommes : tuiles d'au moins autant de lignes
+    int grain = (2 * radius + 1 > BMP8_FILTER_GRAIN) ? 2 * radius + 1 : BMP8_FILTER_GRAIN;
+    parallel_for((int)img->height, grain, bmp8_boxTask, &task);
 
-    // Application du filtre
-    for (unsigned int y = offset; y < img->height - offset; y++) {
-        for (unsigned int x = offset; x < img->width - offset; x++) {
-            float sum = 0.0f;
+    printf("Flou moyen applique  (rayon = %d)\n", radius);
+}
 
-            for (int i = -offset; i <= offset; i++) {
-                for (int j = -offset; j <= offset; j++) {
-                    int pixelIndex = (y + i) * img->width + (x + j);
-                    sum += img->data[pixelIndex] * kernel[i + offset][j + offset];
+// Nombre minimal de colonnes par tuile pour la passe verticale du flou gaussien récursif
+#define BMP8_IIR_COLUMN_GRAIN 64
+
+/*
+Contexte du flou gaussien récursif : plan flottant de l'image, filtré en place
+*/
+typedef struct {
+    t_bmp8 *img;
+    float *plane;
+    t_recursiveGaussian coefs;
+} t_bmp8_iirTask;
+
+/*
+Passe horizontale : conversion des lignes en flottants puis filtrage aller-retour
+*/
+static void bmp8_iirRowsTask(void *arg, int start, int stop, int worker) {
+    t_bmp8_iirTask *t = arg;
+    size_t width = t->img->width;
+    (void)worker;
+
+    for (int y = start; y < stop; y++) {
+        const unsigned char *src = t->img->data + (size_t)y * width;
+        float *row = t->plane + (size_t)y * width;
+        for (size_t x = 0; x < width; x++) row[x] = src[x];
+        recursiveGaussianLine(&t->coefs, row, (int)width, 1);
+    }
+}
+
+/*
+Passe verticale sur un groupe de colonnes, puis écriture du résultat arrondi dans l'image
+*/
+static void bmp8_iirColumnsTask(void *arg, int start, int stop, int worker) {
+    t_bmp8_iirTask *t = arg;
+    size_t width = t->img->width;
+    int height = (int)t->img->height;
+    (void)worker;
+
+    recursiveGaussianColumns(&t->coefs, t->plane, width, height, start, stop);
+    for (int y = 0; y < height; y++) {
+        const float *row = t->plane + (size_t)y * width;
+        unsigned char *dst = t->img->data + (size_t)y * width;
+        for (int x = start; x < stop; x++) {
+            float v = row[x] + 0.5f;
+            dst[x] = (v <= 0.0f) ? 0 : (v >= 255.0f ? 255 : (unsigned char)v);
+        }
+    }
+}
+
+/*
+Flou gaussien d'écart type quelconque par filtre récursif (voir recursiveGaussianInit)
+- Coût par pixel constant, quel que soit sigma (adapté aux grands sigma, 10 à 30 et plus)
+- Lignes puis colonnes réparties sur le pool de threads
+- Bords : pixels du bord répétés (toute l'image est filtrée)
+- sigma doit être au moins RECURSIVE_GAUSSIAN_MIN_SIGMA
+- Retourne 0 en cas de succès, -1 en cas d'erreur (image inchangée)
+*/
+int bmp8_gaussianBlurSigma(t_bmp8 *img, float sigma) {
+    if (img == NULL || img->data == NULL) {
+        printf("Erreur : image invalide pour bmp8_gaussianBlurSigma.\n");
+        return -1;
+    }
+
+    t_bmp8_iirTask task;
+    task.img = img;
+    if (recursiveGaussianInit(&task.coefs, sigma) != 0) return -1;
+    // Plan flottant pris dans le buffer de travail de l'image (voir bmp8_scratch)
+    task.plane = bmp8_scratch(img, (size_t)img->width * img->height * sizeof(float));
+    if (!task.plane) {
+        printf("Erreur d'allocation mémoire pour le filtre.\n");
+        return -1;
+    }
+
+    parallel_for((int)img->height, BMP8_FILTER_GRAIN, bmp8_iirRowsTask, &task);
+    parallel_for((int)img->width, BMP8_IIR_COLUMN_GRAIN, bmp8_iirColumnsTask, &task);
+
+    printf("Flou gaussien applique  (sigma = %.2f)\n", sigma);
+    return 0;
+}
+
+/*
+Applique un filtre de convolution sans charger l'image entière
+- Lit le fichier par bandes de bandHeight lignes, avec un halo de kernel->radius lignes
+  de chaque côté, filtre la bande puis l'écrit directement dans le fichier de sortie
+- Chaque bande est recopiée avec son halo complété selon le mode de bord (voir borderSet) ;
+  les lignes de halo situées loin de la bande (BORDER_WRAP, BORDER_REFLECT) sont relues à part
+- Mémoire utilisée : environ 3 bandes, quelle que soit la taille de l'image
+- Mêmes bords et mêmes résultats que bmp8_applyKernel (à l'arrondi flottant près pour les
+  noyaux non rationnels)
+- Retourne 0 en cas de succès, -1 en cas d'erreur
+*/
+int bmp8_applyKernelStreamed(const char *inputFile, const char *outputFile,
+                             const t_kernel *kernel, int bandHeight) {
+    if (kernel == NULL) return -1;
+
+    FILE *in = fopen(inputFile, "rb");
+    if (!in) {
+        printf("Erreur : impossible d ouvrir le fichier %s\n", inputFile);
+        return -1;
+    }
+
+    unsigned char header[54];
+    if (fread(header, 1, 54, in) != 54) {
+        printf("Erreur : en-tete illisible dans %s\n", inputFile);
+        fclose(in);
+        return -1;
+    }
+
+    unsigned int offset, width, height;
+    unsigned short depth;
+    memcpy(&offset, &header[10], sizeof(offset));
+    memcpy(&width, &header[18], sizeof(width));
+    memcpy(&height, &header[22], sizeof(height));
+    memcpy(&depth, &header[28], sizeof(depth));
+    if (depth != 8 || offset < 54) {
+        printf("Erreur : image non 8 bits (profondeur = %u)\n", depth);
+        fclose(in);
+        return -1;
+    }
+
+    int w = (int)width, h = (int)height;
+    int off = kernel->radius;
+    if (bandHeight <= 0) bandHeight = BMP8_DEFAULT_BAND_HEIGHT;
+    size_t rowBytes = ((size_t)width + 3) & ~(size_t)3;
+    size_t padStride = (size_t)width + 2 * (size_t)off;
+    int capacity = bandHeight + 2 * off;
+    t_border border = borderGet();
+
+    unsigned char *prefix = memory_alloc(offset);
+    unsigned char *window = memory_alloc((size_t)capacity * rowBytes);
+    unsigned char *padded = memory_alloc((size_t)capacity * padStride);
+    unsigned char *spare = memory_alloc(rowBytes);
+    unsigned char *band = memory_calloc((size_t)bandHeight, rowBytes);
+    FILE *out = fopen(outputFile, "wb");
+    if (!prefix || !window || !padded || !spare || !band || !out) {
+        printf("Erreur : impossible de preparer le filtrage de %s\n", inputFile);
+        memory_free(prefix); memory_free(window); memory_free(padded); memory_free(spare); memory_free(band);
+        if (out) fclose(out);
+        fclose(in);
+        return -1;
+    }
+
+    // En-tête et table des couleurs recopiés tels quels
+    fseek(in, 0, SEEK_SET);
+    int status = (fread(prefix, 1, offset, in) == offset
+                  && fwrite(prefix, 1, offset, out) == offset) ? 0 : -1;
+
+    // Noyau rationnel : même calcul entier exact que bmp8_applyKernel
+    t_kernelDivider divider;
+    int32_t divisor = kernel->divisor;
+    if (divisor) kernelDividerInit(&divider, divisor);
+
+    int first = 0;  // indice (dans le fichier) de la première ligne de window
+    int count = 0;  // nombre de lignes présentes dans window
+    for (int b0 = 0; status == 0 && b0 < h; b0 += bandHeight) {
+        int b1 = (b0 + bandHeight < h) ? b0 + bandHeight : h;
+        int need0 = (b0 - off > 0) ? b0 - off : 0;
+        int need1 = (b1 + off < h) ? b1 + off : h;
+
+        // Garder le halo de la bande précédente, puis lire les nouvelles lignes
+        if (need0 > first) {
+            int drop = need0 - first;
+            memmove(window, window + (size_t)drop * rowBytes, (size_t)(count - drop) * rowBytes);
+            first = need0;
+            count -= drop;
+        }
+        while (first + count < need1) {
+            if (fread(window + (size_t)count * rowBytes, 1, rowBytes, in) != rowBytes) {
+                printf("Erreur : donnees pixels incompletes dans %s\n", inputFile);
+                status = -1;
+                break;
+            }
+            count++;
+        }
+        if (status != 0) break;
+
+        // Bande agrandie : lignes [b0 - off, b1 + off) complétées selon le mode de bord
+        for (int p = b0 - off; status == 0 && p < b1 + off; p++) {
+            int y = borderIndex(&border, p, h);
+            const unsigned char *src = NULL;
+            if (y >= first && y < first + count) {
+                src = window + (size_t)(y - first) * rowBytes;
+            } else if (y >= 0) {
+                // Ligne hors de la fenêtre : lue à part, puis retour à la position de lecture
+                if (fseek(in, (long)(offset + (size_t)y * rowBytes), SEEK_SET) != 0
+                    || fread(spare, 1, rowBytes, in) != rowBytes
+                    || fseek(in, (long)(offset + (size_t)(first + count) * rowBytes), SEEK_SET) != 0) {
+                    printf("Erreur : donnees pixels incompletes dans %s\n", inputFile);
+                    status = -1;
+                    break;
                 }
+                src = spare;
             }
+            borderPadRow(&border, src, padded + (size_t)(p - b0 + off) * padStride, w, off, 1);
+        }
+        if (status != 0) break;
 
-            // Clamp entre 0 et 255
-            int value = (int)(sum + 0.5f);
-            if (value < 0) value = 0;
-            if (value > 255) value = 255;
+        const unsigned char *origin = padded + (size_t)off * padStride + off;
+        for (int y = b0; y < b1; y++) {
+            const unsigned char *src = origin + (size_t)(y - b0) * padStride;
+            unsigned char *dst = band + (size_t)(y - b0) * rowBytes;
+            if (divisor) {
+                bmp8_convolveRowInt(kernel, &divider, src, (ptrdiff_t)padStride, dst, w);
+            } else {
+                bmp8_convolveRow(kernel, src, (ptrdiff_t)padStride, dst, w);
+            }
+        }
 
-            newData[y * img->width + x] = (unsigned char)value;
+        size_t bandBytes = (size_t)(b1 - b0) * rowBytes;
+        if (fwrite(band, 1, bandBytes, out) != bandBytes) {
+            printf("Erreur lors de l ecriture des pixels\n");
+            status = -1;
         }
     }
 
-    // Remplace l'image originale par la nouvelle
-    free(img->data);
-    img->data = newData;
+    memory_free(prefix);
+    memory_free(window);
+    memory_free(padded);
+    memory_free(spare);
+    memory_free(band);
+    fclose(in);
+    if (fclose(out) != 0) status = -1;
+    if (status == 0) printf("Filtre applique par bandes dans %s\n", outputFile);
+    return status;
+}
 
-    printf("Filtre applique  (kernelSize = %d)\n", kernelSize);
+/*
+Version float ** de bmp8_applyKernelStreamed
+*/
+int bmp8_applyFilterStreamed(const char *inputFile, const char *outputFile,
+                             float **kernel, int kernelSize, int bandHeight) {
+    t_kernel *k = createKernelFromMatrix(kernel, kernelSize);
+    if (!k) return -1;
+    int status = bmp8_applyKernelStreamed(inputFile, outputFile, k, bandHeight);
+    destroyKernel(k);
+    return status;
 }
 
 #include <math.h>  // pour round()
 
+// Taille des blocs de pixels répartis sur le pool de threads pour l'histogramme
+#define BMP8_HISTOGRAM_BLOCK 65536
+// Sous-histogrammes entrelacés par thread (un par octet d'un mot de 4 octets)
+#define BMP8_HISTOGRAM_COPIES 4
+
+/*
+Contexte du calcul d'histogramme : BMP8_HISTOGRAM_COPIES x 256 compteurs par thread
+*/
+typedef struct {
+    const unsigned char *data;
+    size_t size;
+    unsigned int *counts;
+} t_bmp8_histogramTask;
+
+/*
+Compte les pixels des blocs [start, stop)
+- 4 pixels consécutifs vont dans 4 sous-histogrammes différents : sur une image peu
+  contrastée, les incréments successifs d'un même niveau ne s'attendent plus les uns les autres
+*/
+static void bmp8_histogramTask(void *arg, int start, int stop, int worker) {
+    t_bmp8_histogramTask *t = arg;
+    unsigned int *h = t->counts + (size_t)worker * BMP8_HISTOGRAM_COPIES * 256;
+    size_t begin = (size_t)start * BMP8_HISTOGRAM_BLOCK;
+    size_t end = (size_t)stop * BMP8_HISTOGRAM_BLOCK;
+    if (end > t->size) end = t->size;
+
+    const unsigned char *p = t->data;
+    size_t i = begin;
+    for (; i + 4 <= end; i += 4) {
+        h[p[i]]++;
+        h[256 + p[i + 1]]++;
+        h[512 + p[i + 2]]++;
+        h[768 + p[i + 3]]++;
+    }
+    for (; i < end; i++) h[p[i]]++;
+}
+
 /*
 Calcule l'histogramme d'une image 8 bits
 - Compte le nombre de pixels pour chaque niveau de gris (0-255)
+- Blocs de pixels répartis sur le pool de threads, sous-histogrammes additionnés à la fin
 */
 unsigned int *bmp8_computeHistogram(t_bmp8 *img) {
     if (!img || !img->data) return NULL;
 
+    int threads = parallel_getThreadCount();
     unsigned int *hist = calloc(256, sizeof(unsigned int));
-    if (!hist) {
+    unsigned int *counts = memory_calloc((size_t)threads * BMP8_HISTOGRAM_COPIES * 256, sizeof(unsigned int));
+    if (!hist || !counts) {
         printf("Erreur allocation histogramme\n");
+        free(hist);
+        memory_free(counts);
         return NULL;
     }
 
-    for (unsigned int i = 0; i < img->dataSize; i++) {
-        hist[img->data[i]]++;
-    }
+    t_bmp8_histogramTask task = {img->data, img->dataSize, counts};
+    int blocks = (int)((img->dataSize + BMP8_HISTOGRAM_BLOCK - 1) / BMP8_HISTOGRAM_BLOCK);
+    parallel_for(blocks, 1, bmp8_histogramTask, &task);
 
+    for (int k = 0; k < threads * BMP8_HISTOGRAM_COPIES; k++) {
+        for (int i = 0; i < 256; i++) hist[i] += counts[(size_t)k * 256 + i];
+    }
+    memory_free(counts);
     return hist;
 }
 
@@ -311,3 +1241,119 @@ void bmp8_equalize(t_bmp8 *img, unsigned int *hist_eq) {
 
     printf("Egalisation d histogramme appliquee\n");
 }
+
+/*
+Contexte CLAHE (voir claheMapping et claheAxis)
+- luts : une table de 256 valeurs par tuile, ligne de tuiles par ligne de tuiles
+- firstX / weightX, firstY / weightY : tuiles voisines et poids d'interpolation de chaque colonne / ligne
+*/
+typedef struct {
+    t_bmp8 *img;
+    int tilesX;
+    int tilesY;
+    float clipLimit;
+    unsigned char *luts;
+    const int *firstX;
+    const int *weightX;
+    const int *firstY;
+    const int *weightY;
+    uint16_t *rowLuts;          // tables de la ligne courante (tilesX x 256), une par thread
+} t_bmp8_claheTask;
+
+/*
+Premier passage : histogramme écrêté et table d'égalisation de chaque tuile [start, stop)
+*/
+static void bmp8_claheTilesTask(void *arg, int start, int stop, int worker) {
+    t_bmp8_claheTask *t = arg;
+    size_t width = t->img->width, height = t->img->height;
+    (void)worker;
+
+    for (int tile = start; tile < stop; tile++) {
+        int tx = tile % t->tilesX, ty = tile / t->tilesX;
+        size_t x0 = width * tx / t->tilesX, x1 = width * (tx + 1) / t->tilesX;
+        size_t y0 = height * ty / t->tilesY, y1 = height * (ty + 1) / t->tilesY;
+
+        unsigned int hist[256] = {0};
+        for (size_t y = y0; y < y1; y++) {
+            const unsigned char *row = t->img->data + y * width;
+            for (size_t x = x0; x < x1; x++) hist[row[x]]++;
+        }
+        claheMapping(hist, (unsigned int)((x1 - x0) * (y1 - y0)), t->clipLimit,
+                     t->luts + (size_t)tile * 256);
+    }
+}
+
+/*
+Deuxième passage : chaque pixel passe par les tables des 4 tuiles voisines, interpolées
+bilinéairement (poids entiers, arrondi au plus proche)
+- Les tables du haut et du bas sont d'abord mélangées une fois par ligne (rowLuts) :
+  2 lectures et 1 mélange par pixel au lieu de 4 et 3
+*/
+static void bmp8_claheTask(void *arg, int start, int stop, int worker) {
+    t_bmp8_claheTask *t = arg;
+    int width = (int)t->img->width;
+    int one = 1 << CLAHE_WEIGHT_BITS;
+    int shift = 2 * CLAHE_WEIGHT_BITS;
+
+    for (int y = start; y < stop; y++) {
+        int ty0 = t->firstY[y], ty1 = ty0 + (ty0 < t->tilesY - 1);
+        int wy = t->weightY[y];
+        const unsigned char *top = t->luts + (size_t)ty0 * t->tilesX * 256;
+        const unsigned char *bottom = t->luts + (size_t)ty1 * t->tilesX * 256;
+        uint16_t *lut = t->rowLuts + (size_t)worker * t->tilesX * 256;
+        for (int k = 0; k < t->tilesX * 256; k++) {
+            lut[k] = (uint16_t)(top[k] * (one - wy) + bottom[k] * wy);
+        }
+
+        unsigned char *row = t->img->data + (size_t)y * width;
+        for (int x = 0; x < width; x++) {
+            int tx0 = t->firstX[x], tx1 = tx0 + (tx0 < t->tilesX - 1);
+            int wx = t->weightX[x];
+            int v = row[x];
+            int value = lut[tx0 * 256 + v] * (one - wx) + lut[tx1 * 256 + v] * wx;
+            row[x] = (unsigned char)((value + (1 << (shift - 1))) >> shift);
+        }
+    }
+}
+
+/*
+Égalisation adaptative à contraste limité (CLAHE)
+- L'image est découpée en tilesX x tilesY tuiles, égalisées chacune avec un histogramme
+  écrêté à clipLimit fois la moyenne (contraste local sans amplifier le bruit des zones unies)
+- Chaque pixel interpole les tables des 4 tuiles dont les centres l'entourent : pas de
+  frontières visibles entre tuiles
+- Tuiles puis lignes réparties sur le pool de threads ; tilesX / tilesY <= 0 : CLAHE_DEFAULT_TILES
+*/
+void bmp8_clahe(t_bmp8 *img, int tilesX, int tilesY, float clipLimit) {
+    if (!img || !img->data || img->width == 0 || img->height == 0) return;
+    if (tilesX <= 0) tilesX = CLAHE_DEFAULT_TILES;
+    if (tilesY <= 0) tilesY = CLAHE_DEFAULT_TILES;
+    if (tilesX > (int)img->width) tilesX = (int)img->width;
+    if (tilesY > (int)img->height) tilesY = (int)img->height;
+
+    t_bmp8_claheTask task = {img, tilesX, tilesY, clipLimit, NULL, NULL, NULL, NULL, NULL, NULL};
+    task.luts = memory_alloc((size_t)tilesX * tilesY * 256);
+    task.rowLuts = memory_alloc((size_t)parallel_getThreadCount() * tilesX * 256 * sizeof(uint16_t));
+    int *axes = memory_alloc(2 * ((size_t)img->width + img->height) * sizeof(int));
+    if (!task.luts || !task.rowLuts || !axes) {
+        printf("Erreur allocation CLAHE\n");
+        memory_free(task.luts);
+        memory_free(task.rowLuts);
+        memory_free(axes);
+        return;
+    }
+    task.firstX = axes;
+    task.weightX = axes + img->width;
+    task.firstY = axes + 2 * (size_t)img->width;
+    task.weightY = task.firstY + img->height;
+    claheAxis((int)img->width, tilesX, axes, axes + img->width);
+    claheAxis((int)img->height, tilesY, axes + 2 * (size_t)img->width, axes + 2 * (size_t)img->width + img->height);
+
+    parallel_for(tilesX * tilesY, 1, bmp8_claheTilesTask, &task);
+    parallel_for((int)img->height, BMP8_FILTER_GRAIN, bmp8_claheTask, &task);
+
+    memory_free(task.luts);
+    memory_free(task.rowLuts);
+    memory_free(axes);
+    printf("CLAHE applique  (tuiles %d x %d, limite %.1f)\n", tilesX, tilesY, clipLimit);
+}
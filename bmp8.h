@@ -1,7 +1,14 @@
 #ifndef BMP8_H
 #define BMP8_H
 
+#include <stddef.h>
+#include "filtres.h"
+
 // Structure représentant une image BMP 8 bits
+// - mapping : non NULL si l'image a été chargée par projection mémoire,
+//   data pointe alors directement dans le fichier projeté
+// - scratch : buffer de travail des filtres (copie agrandie, buffers par thread), gardé entre
+//   deux traitements et agrandi au besoin ; libéré par bmp8_free ou bmp8_releaseScratch
 typedef struct {
     unsigned char header[54];
     unsigned char colorTable[1024];
@@ -10,21 +17,72 @@ typedef struct {
     unsigned int height;
     unsigned int colorDepth;
     unsigned int dataSize;
+    void *mapping;
+    size_t mappingSize;
+    void *scratch;
+    size_t scratchSize;
 } t_bmp8;
 
 // Fonctions de base
 t_bmp8* bmp8_loadImage(const char *filename);
-void bmp8_saveImage(const char *filename, t_bmp8 *img);
+t_bmp8* bmp8_loadImageMapped(const char *filename);
+// bmp8_saveImage retourne 0, ou -1 si le fichier n'a pas pu être écrit
+int bmp8_saveImage(const char *filename, t_bmp8 *img);
 void bmp8_free(t_bmp8 *img);
 void bmp8_printInfo(t_bmp8 *img);
+void bmp8_releaseScratch(t_bmp8 *img);
 
 // Traitements simples
 void bmp8_negative(t_bmp8 *img);
 void bmp8_brightness(t_bmp8 *img, int value);
 void bmp8_threshold(t_bmp8 *img, int threshold);
 
-// Filtres convolutifs
+// Chaîne de traitements point à point, appliquée en une seule passe sur les pixels
+// - lut : composition de toutes les étapes (table de 256 valeurs)
+// - steps : étapes enregistrées, rejouées par blocs tenant dans le cache (SSE2/AVX2)
+// - lutOnly : la chaîne contient une courbe ou trop d'étapes, seule la table est utilisée
+#define BMP8_CHAIN_MAX_STEPS 8
+
+typedef enum {
+    BMP8_STEP_NEGATIVE,
+    BMP8_STEP_BRIGHTNESS,
+    BMP8_STEP_THRESHOLD
+} t_bmp8_stepType;
+
+typedef struct {
+    t_bmp8_stepType type;
+    int value;
+} t_bmp8_step;
+
+typedef struct {
+    unsigned char lut[256];
+    t_bmp8_step steps[BMP8_CHAIN_MAX_STEPS];
+    int stepCount;
+    int lutOnly;
+} t_bmp8_chain;
+
+void bmp8_chainInit(t_bmp8_chain *chain);
+void bmp8_chainNegative(t_bmp8_chain *chain);
+void bmp8_chainBrightness(t_bmp8_chain *chain, int value);
+void bmp8_chainThreshold(t_bmp8_chain *chain, int threshold);
+void bmp8_chainCurve(t_bmp8_chain *chain, const unsigned char curve[256]);
+void bmp8_chainApply(t_bmp8 *img, const t_bmp8_chain *chain);
+
+// Filtres convolutifs (noyau t_kernel de taille impaire quelconque, ou matrice float **)
+void bmp8_applyKernel(t_bmp8 *img, const t_kernel *kernel);
 void bmp8_applyFilter(t_bmp8 *img, float **kernel, int kernelSize);
+// Flou moyen de rayon quelconque, coût par pixel indépendant du rayon (sommes glissantes)
+void bmp8_boxBlurRadius(t_bmp8 *img, int radius);
+// Flou gaussien récursif, coût par pixel indépendant de sigma
+int bmp8_gaussianBlurSigma(t_bmp8 *img, float sigma);
+
+// Filtre par bandes : lit, filtre et écrit le fichier bande par bande
+// (mémoire proportionnelle à bandHeight, pas à la taille de l'image)
+#define BMP8_DEFAULT_BAND_HEIGHT 256
+int bmp8_applyKernelStreamed(const char *inputFile, const char *outputFile,
+                             const t_kernel *kernel, int bandHeight);
+int bmp8_applyFilterStreamed(const char *inputFile, const char *outputFile,
+                             float **kernel, int kernelSize, int bandHeight);
 
 #endif
 
@@ -40,5 +98,7 @@ void freeKernel(float **kernel);
 unsigned int *bmp8_computeHistogram(t_bmp8 *img);
 unsigned int *bmp8_computeCDF(unsigned int *hist, unsigned int dataSize);
 void bmp8_equalize(t_bmp8 *img, unsigned int *hist_eq);
+// Égalisation adaptative à contraste limité (CLAHE), voir claheMapping
+void bmp8_clahe(t_bmp8 *img, int tilesX, int tilesY, float clipLimit);
 
 
@@ -1,41 +1,63 @@
+#include <math.h>
+#include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include "filtres.h"
+#include "memoire.h"
 
 /**
-Crée un noyau de flou moyen (Box Blur)
-- Matrice 3x3 avec toutes les valeurs à 1/9
-- Permet un floutage uniforme de l'image
+Alloue une matrice de noyau size x size en un seul bloc
+- Les pointeurs de lignes et les coefficients sont dans la même allocation :
+  freeKernel libère le noyau d'un seul memory_free, quelle que soit sa taille
 */
-float **createBoxBlurKernel() {
-    float **kernel = malloc(3 * sizeof(float *));
+float **allocateKernelMatrix(int size) {
+    float **kernel = memory_alloc(size * sizeof(float *) + (size_t)size * size * sizeof(float));
+    if (!kernel) return NULL;
+    float *values = (float *)(kernel + size);
+    for (int i = 0; i < size; i++) {
+        kernel[i] = values + (size_t)i * size;
+    }
+    return kernel;
+}
+
+// Remplit un noyau 3x3 à partir de valeurs entières divisées par divisor
+static float **createKernel3x3(const int values[3][3], float divisor) {
+    float **kernel = allocateKernelMatrix(3);
+    if (!kernel) return NULL;
     for (int i = 0; i < 3; i++) {
-        kernel[i] = malloc(3 * sizeof(float));
         for (int j = 0; j < 3; j++) {
-            kernel[i][j] = 1.0f / 9.0f; // Normalisation pour que la somme = 1
+            kernel[i][j] = values[i][j] / divisor;
         }
     }
     return kernel;
 }
 
+/**
+Crée un noyau de flou moyen (Box Blur)
+- Matrice 3x3 avec toutes les valeurs à 1/9
+- Permet un floutage uniforme de l'image
+*/
+float **createBoxBlurKernel() {
+    const int values[3][3] = {
+        {1, 1, 1},
+        {1, 1, 1},
+        {1, 1, 1}
+    };
+    return createKernel3x3(values, 9.0f); // Normalisation pour que la somme = 1
+}
+
 /**
 Crée un noyau de flou gaussien
 - Pondération plus forte au centre
 - Réduit le bruit tout en préservant mieux les contours
 */
 float **createGaussianBlurKernel() {
-    float values[3][3] = {
+    const int values[3][3] = {
         {1, 2, 1},
         {2, 4, 2},
         {1, 2, 1}
     };
-    float **kernel = malloc(3 * sizeof(float *));
-    for (int i = 0; i < 3; i++) {
-        kernel[i] = malloc(3 * sizeof(float));
-        for (int j = 0; j < 3; j++) {
-            kernel[i][j] = values[i][j] / 16.0f; // Normalisation (somme = 1)
-        }
-    }
-    return kernel;
+    return createKernel3x3(values, 16.0f); // Normalisation (somme = 1)
 }
 
 /**
@@ -44,19 +66,12 @@ Crée un noyau de détection de contours (Outline)
 - Met en évidence les transitions de couleur
 */
 float **createOutlineKernel() {
-    int values[3][3] = {
+    const int values[3][3] = {
         {-1, -1, -1},
         {-1,  8, -1},
         {-1, -1, -1}
     };
-    float **kernel = malloc(3 * sizeof(float *));
-    for (int i = 0; i < 3; i++) {
-        kernel[i] = malloc(3 * sizeof(float));
-        for (int j = 0; j < 3; j++) {
-            kernel[i][j] = (float)values[i][j];
-        }
-    }
-    return kernel;
+    return createKernel3x3(values, 1.0f);
 }
 
 /**
@@ -64,19 +79,12 @@ Crée un noyau de relief (Emboss)
 - Simule un effet 3D en jouant sur les dégradés
 */
 float **createEmbossKernel() {
-    int values[3][3] = {
+    const int values[3][3] = {
         {-2, -1, 0},
         {-1,  1, 1},
         { 0,  1, 2}
     };
-    float **kernel = malloc(3 * sizeof(float *));
-    for (int i = 0; i < 3; i++) {
-        kernel[i] = malloc(3 * sizeof(float));
-        for (int j = 0; j < 3; j++) {
-            kernel[i][j] = (float)values[i][j];
-        }
-    }
-    return kernel;
+    return createKernel3x3(values, 1.0f);
 }
 
 /**
@@ -84,27 +92,632 @@ Crée un noyau de netteté (Sharpen)
 - Renforce les contours en accentuant les contrastes locaux
 */
 float **createSharpenKernel() {
-    int values[3][3] = {
+    const int values[3][3] = {
         { 0, -1,  0},
         {-1,  5, -1},
         { 0, -1,  0}
     };
-    float **kernel = malloc(3 * sizeof(float *));
-    for (int i = 0; i < 3; i++) {
-        kernel[i] = malloc(3 * sizeof(float));
-        for (int j = 0; j < 3; j++) {
-            kernel[i][j] = (float)values[i][j];
+    return createKernel3x3(values, 1.0f);
+}
+
+/**
+Libère la mémoire d'un noyau de convolution (créé par allocateKernelMatrix ou create*Kernel)
+*/
+void freeKernel(float **kernel) {
+    memory_free(kernel);
+}
+
+
+/**
+Décompose un noyau séparable en un noyau ligne et un noyau colonne
+- Un noyau est séparable s'il est de rang 1 : kernel[i][j] = colKernel[i] * rowKernel[j]
+  (c'est le cas du flou moyen et du flou gaussien)
+- La ligne du pivot (coefficient de plus grande valeur absolue) donne rowKernel,
+  normalisée par sa somme : pour les noyaux binomiaux (gaussiens) les deux facteurs
+  restent des fractions de puissances de 2, donc exacts en flottant
+- Retourne 1 et remplit rowKernel / colKernel (kernelSize valeurs) si le noyau est séparable, 0 sinon
+*/
+int separateKernel(float **kernel, int kernelSize, float *rowKernel, float *colKernel) {
+    int pi = 0, pj = 0;
+    float maxAbs = 0.0f;
+    for (int i = 0; i < kernelSize; i++) {
+        for (int j = 0; j < kernelSize; j++) {
+            if (fabsf(kernel[i][j]) > maxAbs) {
+                maxAbs = fabsf(kernel[i][j]);
+                pi = i;
+                pj = j;
+            }
+        }
+    }
+    if (maxAbs == 0.0f) return 0;
+
+    // Normalisation par la somme de la ligne du pivot, ou par le pivot si cette somme est nulle
+    float norm = 0.0f;
+    for (int j = 0; j < kernelSize; j++) norm += kernel[pi][j];
+    if (fabsf(norm) < maxAbs * 1e-3f) norm = kernel[pi][pj];
+
+    for (int j = 0; j < kernelSize; j++) {
+        rowKernel[j] = kernel[pi][j] / norm;
+    }
+    for (int i = 0; i < kernelSize; i++) {
+        colKernel[i] = kernel[i][pj] / rowKernel[pj];
+    }
+
+    // Vérifie que le produit colonne × ligne redonne bien le noyau
+    float tolerance = maxAbs * 1e-6f;
+    for (int i = 0; i < kernelSize; i++) {
+        for (int j = 0; j < kernelSize; j++) {
+            if (fabsf(colKernel[i] * rowKernel[j] - kernel[i][j]) > tolerance) return 0;
+        }
+    }
+    return 1;
+}
+
+// Tolérance relative de l'ordre de la précision des float (les valeurs sont des fractions arrondies)
+static int isIntegral(double scaled) {
+    return fabs(scaled - floor(scaled + 0.5)) <= 4e-7 * (fabs(scaled) > 1.0 ? fabs(scaled) : 1.0);
+}
+
+/**
+Vérifie un diviseur : toutes les valeurs * divisor entières, poids remplis
+*/
+static int checkDivisor(const float *values, int count, int64_t divisor, int32_t *weights) {
+    double total = 0.0;
+    for (int k = 0; k < count; k++) {
+        double scaled = (double)values[k] * divisor;
+        if (!isIntegral(scaled)) return 0;
+        weights[k] = (int32_t)floor(scaled + 0.5);
+        total += fabs((double)weights[k]);
+    }
+    // Somme des |poids| x 255 sur 32 bits
+    return total <= (1 << 22);
+}
+
+/**
+Cherche le plus petit diviseur D pour lequel toutes les valeurs * D sont entières
+- Les noyaux fournis sont rationnels : flou moyen 1/9, gaussien /16, noyaux entiers
+- Candidats tirés du plus petit coefficient non entier v : un D qui convient rend v * D entier,
+  donc D = arrondi(p / |v|) pour p = 1, 2... (candidats croissants, au plus |v| x KERNEL_MAX_DIVISOR
+  au lieu de tous les entiers) ; le premier qui convient est le plus petit
+- Les sommes de pixels x poids doivent tenir sur 32 bits
+- Retourne D, ou 0 si aucun diviseur jusqu'à KERNEL_MAX_DIVISOR ne convient
+*/
+int vectorToInteger(const float *values, int count, int32_t *weights) {
+    if (checkDivisor(values, count, 1, weights)) return 1;
+
+    // |v| < 4e-7 : v * D ne peut être entier qu'en étant nul, v ne donne pas de candidats
+    double smallest = 0.0;
+    for (int k = 0; k < count; k++) {
+        double magnitude = fabs((double)values[k]);
+        if (magnitude >= 4e-7 && !isIntegral(magnitude) && (smallest == 0.0 || magnitude < smallest)) {
+            smallest = magnitude;
         }
     }
+    if (smallest == 0.0) return 0;
+
+    int64_t previous = 1;
+    for (int64_t p = 1; ; p++) {
+        int64_t divisor = (int64_t)floor(p / smallest + 0.5);
+        if (divisor > KERNEL_MAX_DIVISOR) return 0;
+        if (divisor <= previous) continue;
+        previous = divisor;
+        if (checkDivisor(values, count, divisor, weights)) return (int)divisor;
+    }
+}
+
+/**
+Forme entière d'un noyau 2D (voir vectorToInteger)
+*/
+int kernelToInteger(float **kernel, int kernelSize, int32_t *weights) {
+    int count = kernelSize * kernelSize;
+    float *values = memory_alloc(count * sizeof(float));
+    if (!values) return 0;
+    for (int i = 0; i < kernelSize; i++) {
+        for (int j = 0; j < kernelSize; j++) {
+            values[i * kernelSize + j] = kernel[i][j];
+        }
+    }
+    int divisor = vectorToInteger(values, count, weights);
+    memory_free(values);
+    return divisor;
+}
+
+/**
+Forme entière des deux facteurs d'un noyau séparable (voir separateKernel)
+- Diviseur = produit des diviseurs des deux facteurs
+- Les sommes des deux passes (au plus 255 x sum|row| x sum|col|) doivent tenir sur 32 bits
+*/
+int separableToInteger(const float *rowKernel, const float *colKernel, int kernelSize,
+                       int32_t *intRow, int32_t *intCol) {
+    int64_t rowDivisor = vectorToInteger(rowKernel, kernelSize, intRow);
+    int64_t colDivisor = vectorToInteger(colKernel, kernelSize, intCol);
+    if (!rowDivisor || !colDivisor || rowDivisor * colDivisor > KERNEL_MAX_SEPARABLE_DIVISOR) return 0;
+
+    int64_t rowSum = 0, colSum = 0;
+    for (int k = 0; k < kernelSize; k++) {
+        rowSum += intRow[k] < 0 ? -intRow[k] : intRow[k];
+        colSum += intCol[k] < 0 ? -intCol[k] : intCol[k];
+    }
+    if (255 * rowSum * colSum >= ((int64_t)1 << 31)) return 0;
+    return (int)(rowDivisor * colDivisor);
+}
+
+/**
+Prépare la division arrondie par divisor
+- round(sum / D) = floor((2 sum + D) / 2D), calculé par (n * m) >> (32 + l)
+  avec l = ceil(log2(2D)) et m = floor(2^(32 + l) / 2D) + 1 : exact pour n < 2^32
+- Seules les sommes de [1, 255.5 D) passent par la multiplication
+*/
+void kernelDividerInit(t_kernelDivider *d, int32_t divisor) {
+    if (divisor < 1) divisor = 1;
+    uint64_t twice = 2 * (uint64_t)divisor;
+    int l = 0;
+    while (((uint64_t)1 << l) < twice) l++;
+
+    d->divisor = divisor;
+    d->limit = (511 * divisor + 1) / 2;   // sum / D >= 255.5
+    d->shift = 32 + l;
+    d->multiplier = ((uint64_t)1 << d->shift) / twice + 1;
+}
+
+/**
+Alloue un noyau size x size et toutes ses métadonnées en un seul bloc
+- Les tableaux sont placés après la structure, du plus aligné au moins aligné
+*/
+static t_kernel *allocateKernel(int size) {
+    size_t count = (size_t)size * size;
+    size_t bytes = sizeof(t_kernel)
+                   + count * sizeof(t_kernelTap)
+                   + size * sizeof(float *)
+                   + (count + 2 * size) * sizeof(float)
+                   + (count + 2 * size) * sizeof(int32_t)
+                   + 9 * sizeof(int16_t);
+    t_kernel *kernel = memory_calloc(1, bytes);
+    if (!kernel) return NULL;
+
+    char *p = (char *)(kernel + 1);
+    kernel->taps = (t_kernelTap *)p;        p += count * sizeof(t_kernelTap);
+    kernel->rows = (float **)p;             p += size * sizeof(float *);
+    kernel->values = (float *)p;            p += count * sizeof(float);
+    kernel->rowKernel = (float *)p;         p += size * sizeof(float);
+    kernel->colKernel = (float *)p;         p += size * sizeof(float);
+    kernel->weights = (int32_t *)p;         p += count * sizeof(int32_t);
+    kernel->intRow = (int32_t *)p;          p += size * sizeof(int32_t);
+    kernel->intCol = (int32_t *)p;          p += size * sizeof(int32_t);
+    kernel->fixed = (int16_t *)p;
+
+    kernel->size = size;
+    kernel->radius = size / 2;
+    for (int i = 0; i < size; i++) {
+        kernel->rows[i] = kernel->values + (size_t)i * size;
+    }
     return kernel;
 }
 
 /**
-Libère la mémoire d'un noyau de convolution
+Formes entières d'un noyau connu sous la forme noyau[i][j] = factor[i] factor[j] / scale²
+(flou moyen, gaussien) : diviseurs posés directement, sans recherche
+- factor et scale sont d'abord réduits par leur pgcd (plus petits diviseurs)
+- factor peut être kernel->intRow
 */
-void freeKernel(float **kernel) {
-    for (int i = 0; i < 3; i++) {
-        free(kernel[i]);
+static void setFactoredIntegers(t_kernel *kernel, const int32_t *factor, int32_t scale) {
+    int size = kernel->size;
+    int32_t common = scale;
+    for (int k = 0; k < size; k++) {
+        int32_t a = common, b = factor[k] < 0 ? -factor[k] : factor[k];
+        while (b) {
+            int32_t r = a % b;
+            a = b;
+            b = r;
+        }
+        common = a;
+    }
+    int64_t reduced = scale / common;
+    int64_t factorSum = 0;
+    for (int k = 0; k < size; k++) {
+        kernel->intRow[k] = kernel->intCol[k] = factor[k] / common;
+        kernel->rowKernel[k] = kernel->colKernel[k] = (float)kernel->intRow[k] / (float)reduced;
+        factorSum += kernel->intRow[k] < 0 ? -kernel->intRow[k] : kernel->intRow[k];
+    }
+    kernel->separable = 1;
+
+    // Mêmes limites que separableToInteger et vectorToInteger (sommes sur 32 bits)
+    kernel->separableDivisor = (reduced * reduced <= KERNEL_MAX_SEPARABLE_DIVISOR
+                                && 255 * factorSum * factorSum < ((int64_t)1 << 31))
+        ? (int32_t)(reduced * reduced) : 0;
+    kernel->divisor = 0;
+    if (reduced * reduced <= KERNEL_MAX_DIVISOR && factorSum * factorSum <= (1 << 22)) {
+        kernel->divisor = (int32_t)(reduced * reduced);
+        for (int i = 0; i < size; i++) {
+            for (int j = 0; j < size; j++) {
+                kernel->weights[i * size + j] = kernel->intCol[i] * kernel->intRow[j];
+            }
+        }
+    }
+}
+
+/**
+Calcule les métadonnées d'un noyau dont les coefficients sont remplis
+- factor (ou NULL) : facteur entier connu du constructeur (voir setFactoredIntegers), sinon les
+  formes séparable et entière sont cherchées à partir des coefficients
+*/
+static void analyzeKernel(t_kernel *kernel, const int32_t *factor, int32_t scale) {
+    int size = kernel->size;
+    int radius = kernel->radius;
+
+    kernel->sum = 0.0f;
+    kernel->zeroTaps = 0;
+    kernel->symmetric = 1;
+    for (int i = 0; i < size; i++) {
+        for (int j = 0; j < size; j++) {
+            float v = kernel->rows[i][j];
+            kernel->sum += v;
+            if (v == 0.0f) kernel->zeroTaps++;
+            if (v != kernel->rows[i][size - 1 - j] || v != kernel->rows[size - 1 - i][j]) kernel->symmetric = 0;
+        }
+    }
+
+    if (factor) {
+        setFactoredIntegers(kernel, factor, scale);
+    } else {
+        kernel->separable = separateKernel(kernel->rows, size, kernel->rowKernel, kernel->colKernel);
+        kernel->separableDivisor = kernel->separable
+            ? separableToInteger(kernel->rowKernel, kernel->colKernel, size, kernel->intRow, kernel->intCol)
+            : 0;
+        kernel->divisor = kernelToInteger(kernel->rows, size, kernel->weights);
+    }
+    // Chemin 3x3 vectorisé : poids entiers exacts sur 16 bits, même diviseur (voir simd_convolve3x3)
+    kernel->fixedDivisor = 0;
+    if (size == 3 && kernel->divisor > 0) {
+        int fits = 1;
+        for (int k = 0; k < 9; k++) {
+            if (kernel->weights[k] > 32767 || kernel->weights[k] < -32768) fits = 0;
+            else kernel->fixed[k] = (int16_t)kernel->weights[k];
+        }
+        if (fits) kernel->fixedDivisor = kernel->divisor;
+    }
+
+    kernel->tapCount = 0;
+    for (int i = 0; i < size; i++) {
+        for (int j = 0; j < size; j++) {
+            if (kernel->rows[i][j] == 0.0f) continue;
+            t_kernelTap *tap = &kernel->taps[kernel->tapCount++];
+            tap->dy = i - radius;
+            tap->dx = j - radius;
+            tap->value = kernel->rows[i][j];
+            tap->weight = kernel->divisor ? kernel->weights[i * size + j] : 0;
+        }
+    }
+}
+
+/**
+Crée un noyau à partir de size x size coefficients (ligne par ligne)
+- size doit être impair
+- Retourne NULL si size est invalide ou en cas d'échec d'allocation
+*/
+t_kernel *createKernel(int size, const float *values) {
+    if (size < 1 || size % 2 == 0) {
+        printf("Erreur : taille de noyau invalide (%d), impaire attendue\n", size);
+        return NULL;
+    }
+    t_kernel *kernel = allocateKernel(size);
+    if (!kernel) return NULL;
+    memcpy(kernel->values, values, (size_t)size * size * sizeof(float));
+    analyzeKernel(kernel, NULL, 0);
+    return kernel;
+}
+
+/**
+Crée un noyau à partir d'une matrice float ** (par exemple createBoxBlurKernel())
+*/
+t_kernel *createKernelFromMatrix(float **matrix, int size) {
+    if (size < 1 || size % 2 == 0) {
+        printf("Erreur : taille de noyau invalide (%d), impaire attendue\n", size);
+        return NULL;
+    }
+    t_kernel *kernel = allocateKernel(size);
+    if (!kernel) return NULL;
+    for (int i = 0; i < size; i++) {
+        memcpy(kernel->rows[i], matrix[i], size * sizeof(float));
+    }
+    analyzeKernel(kernel, NULL, 0);
+    return kernel;
+}
+
+/**
+Crée un noyau de flou moyen de rayon quelconque ((2 radius + 1)² coefficients égaux)
+- radius = 1 : même noyau que createBoxBlurKernel
+*/
+t_kernel *createBoxKernel(int radius) {
+    if (radius < 0) radius = 0;
+    int size = 2 * radius + 1;
+    t_kernel *kernel = allocateKernel(size);
+    if (!kernel) return NULL;
+    for (int k = 0; k < size * size; k++) {
+        kernel->values[k] = 1.0f / (float)(size * size);
+    }
+    for (int k = 0; k < size; k++) {
+        kernel->intRow[k] = 1;
+    }
+    analyzeKernel(kernel, kernel->intRow, size);
+    return kernel;
+}
+
+// Somme des poids entiers d'une ligne du noyau gaussien (diviseur de chaque facteur)
+#define KERNEL_GAUSSIAN_SCALE 1024
+
+/**
+Crée un noyau gaussien de rayon et d'écart type quelconques
+- sigma <= 0 : sigma = 0.3 (radius - 1) + 0.8 (radius = 1 donne un noyau proche de 1-2-1)
+- radius <= 0 : radius = ceil(3 sigma)
+- Poids 1D entiers de somme KERNEL_GAUSSIAN_SCALE : noyau[i][j] = g[i] g[j] / 1024²,
+  exact en flottant, séparable et rationnel (calculs entiers en deux passes)
+*/
+t_kernel *createGaussianKernel(int radius, float sigma) {
+    if (sigma <= 0.0f && radius <= 0) radius = 1;
+    if (sigma <= 0.0f) sigma = 0.3f * (radius - 1) + 0.8f;
+    if (radius <= 0) radius = (int)ceilf(3.0f * sigma);
+
+    int size = 2 * radius + 1;
+    double *g = memory_alloc(size * sizeof(double));
+    int32_t *q = memory_alloc(size * sizeof(int32_t));
+    t_kernel *kernel = (g && q) ? allocateKernel(size) : NULL;
+    if (!kernel) {
+        memory_free(g);
+        memory_free(q);
+        return NULL;
+    }
+
+    double total = 0.0;
+    for (int k = 0; k < size; k++) {
+        double d = k - radius;
+        g[k] = exp(-d * d / (2.0 * sigma * sigma));
+        total += g[k];
+    }
+    int32_t quantized = 0;
+    for (int k = 0; k < size; k++) {
+        q[k] = (int32_t)floor(g[k] * KERNEL_GAUSSIAN_SCALE / total + 0.5);
+        quantized += q[k];
+    }
+    q[radius] += KERNEL_GAUSSIAN_SCALE - quantized;  // somme exacte : reste porté par le centre
+
+    for (int i = 0; i < size; i++) {
+        for (int j = 0; j < size; j++) {
+            kernel->rows[i][j] = (float)q[i] * (float)q[j] / (float)(KERNEL_GAUSSIAN_SCALE * KERNEL_GAUSSIAN_SCALE);
+        }
+    }
+    analyzeKernel(kernel, q, KERNEL_GAUSSIAN_SCALE);
+    memory_free(g);
+    memory_free(q);
+    return kernel;
+}
+
+/**
+Libère un noyau créé par createKernel, createBoxKernel, createGaussianKernel...
+*/
+void destroyKernel(t_kernel *kernel) {
+    memory_free(kernel);
+}
+
+// Mode de bord commun à tous les filtres (voir borderSet)
+static t_border border_current = {BORDER_CLAMP, 0};
+
+/**
+Choisit le mode de bord de tous les filtres
+- value : niveau des pixels hors de l'image pour BORDER_CONSTANT (borné à [0, 255])
+- À appeler avant les traitements (le mode est lu au début de chaque filtre)
+*/
+void borderSet(t_borderMode mode, int value) {
+    border_current.mode = mode;
+    border_current.value = value < 0 ? 0 : (value > 255 ? 255 : value);
+}
+
+t_border borderGet(void) {
+    return border_current;
+}
+
+const char *borderModeName(t_borderMode mode) {
+    switch (mode) {
+        case BORDER_REFLECT: return "reflect";
+        case BORDER_WRAP: return "wrap";
+        case BORDER_CONSTANT: return "constant";
+        default: return "clamp";
+    }
+}
+
+/**
+Position du voisin d'indice i sur un axe de n pixels
+- i dans [0, n) : i lui-même ; sinon d'après le mode (miroir et répétition périodiques,
+  valables même si le rayon dépasse la taille de l'image)
+- Retourne -1 pour BORDER_CONSTANT hors de l'image
+*/
+int borderIndex(const t_border *border, int i, int n) {
+    if (i >= 0 && i < n) return i;
+    switch (border->mode) {
+        case BORDER_REFLECT: {
+            if (n == 1) return 0;
+            int period = 2 * n - 2;
+            i %= period;
+            if (i < 0) i += period;
+            return i < n ? i : period - i;
+        }
+        case BORDER_WRAP:
+            i %= n;
+            return i < 0 ? i + n : i;
+        case BORDER_CONSTANT:
+            return -1;
+        default:
+            return i < 0 ? 0 : n - 1;
+    }
+}
+
+/**
+Construit une ligne agrandie de radius pixels de chaque côté
+- Centre : copie des width pixels de src ; halos : voisins donnés par borderIndex
+- src NULL (ligne hors de l'image en BORDER_CONSTANT) : ligne entière au niveau constant
+*/
+void borderPadRow(const t_border *border, const uint8_t *src, uint8_t *dst, int width, int radius,
+                  int pixelSize) {
+    size_t rowBytes = (size_t)width * pixelSize;
+    if (src == NULL) {
+        memset(dst, border->value, rowBytes + 2 * (size_t)radius * pixelSize);
+        return;
+    }
+
+    memcpy(dst + (size_t)radius * pixelSize, src, rowBytes);
+    for (int k = 1; k <= radius; k++) {
+        uint8_t *left = dst + (size_t)(radius - k) * pixelSize;
+        uint8_t *right = dst + (size_t)(radius + width - 1 + k) * pixelSize;
+        int l = borderIndex(border, -k, width);
+        int r = borderIndex(border, width - 1 + k, width);
+        if (l < 0) memset(left, border->value, pixelSize);
+        else memcpy(left, src + (size_t)l * pixelSize, pixelSize);
+        if (r < 0) memset(right, border->value, pixelSize);
+        else memcpy(right, src + (size_t)r * pixelSize, pixelSize);
+    }
+}
+
+/**
+Coefficients du filtre gaussien récursif (Young et van Vliet, 1995)
+- sigma >= RECURSIVE_GAUSSIAN_MIN_SIGMA, sinon retourne -1
+- Gain statique unitaire : b + a1 + a2 + a3 = 1 (une image uniforme reste inchangée)
+*/
+int recursiveGaussianInit(t_recursiveGaussian *g, float sigma) {
+    if (sigma < RECURSIVE_GAUSSIAN_MIN_SIGMA) {
+        printf("Erreur : sigma trop petit (%.2f), minimum %.2f\n", sigma, RECURSIVE_GAUSSIAN_MIN_SIGMA);
+        return -1;
+    }
+
+    double q = (sigma >= 2.5) ? 0.98711 * sigma - 0.96330
+                              : 3.97156 - 4.14554 * sqrt(1.0 - 0.26891 * sigma);
+    double q2 = q * q, q3 = q2 * q;
+    double b0 = 1.57825 + 2.44413 * q + 1.4281 * q2 + 0.422205 * q3;
+    double b1 = 2.44413 * q + 2.85619 * q2 + 1.26661 * q3;
+    double b2 = -(1.4281 * q2 + 1.26661 * q3);
+    double b3 = 0.422205 * q3;
+
+    g->a1 = (float)(b1 / b0);
+    g->a2 = (float)(b2 / b0);
+    g->a3 = (float)(b3 / b0);
+    g->b = (float)(1.0 - (b1 + b2 + b3) / b0);
+    return 0;
+}
+
+/**
+Passe récursive aller puis retour sur count échantillons espacés de stride (en place)
+*/
+void recursiveGaussianLine(const t_recursiveGaussian *g, float *values, int count, int stride) {
+    if (count <= 0) return;
+
+    float w1 = values[0], w2 = w1, w3 = w1;
+    for (int i = 0; i < count; i++) {
+        float w = g->b * values[(size_t)i * stride] + g->a1 * w1 + g->a2 * w2 + g->a3 * w3;
+        values[(size_t)i * stride] = w;
+        w3 = w2;
+        w2 = w1;
+        w1 = w;
+    }
+
+    w1 = values[(size_t)(count - 1) * stride];
+    w2 = w1;
+    w3 = w1;
+    for (int i = count - 1; i >= 0; i--) {
+        float w = g->b * values[(size_t)i * stride] + g->a1 * w1 + g->a2 * w2 + g->a3 * w3;
+        values[(size_t)i * stride] = w;
+        w3 = w2;
+        w2 = w1;
+        w1 = w;
+    }
+}
+
+/**
+Passes récursives verticales sur les colonnes [x0, x1) d'un plan de height lignes (en place)
+- Parcours ligne par ligne : accès contigus, boucle intérieure vectorisable
+- Les lignes précédentes (ou suivantes) servent d'état, bornées à la première (ou dernière)
+*/
+void recursiveGaussianColumns(const t_recursiveGaussian *g, float *plane, size_t rowStride, int height,
+                              int x0, int x1) {
+    for (int y = 0; y < height; y++) {
+        float *cur = plane + (size_t)y * rowStride;
+        const float *p1 = plane + (size_t)(y >= 1 ? y - 1 : 0) * rowStride;
+        const float *p2 = plane + (size_t)(y >= 2 ? y - 2 : 0) * rowStride;
+        const float *p3 = plane + (size_t)(y >= 3 ? y - 3 : 0) * rowStride;
+        for (int x = x0; x < x1; x++) {
+            cur[x] = g->b * cur[x] + g->a1 * p1[x] + g->a2 * p2[x] + g->a3 * p3[x];
+        }
+    }
+
+    for (int y = height - 1; y >= 0; y--) {
+        float *cur = plane + (size_t)y * rowStride;
+        const float *n1 = plane + (size_t)(y + 1 < height ? y + 1 : height - 1) * rowStride;
+        const float *n2 = plane + (size_t)(y + 2 < height ? y + 2 : height - 1) * rowStride;
+        const float *n3 = plane + (size_t)(y + 3 < height ? y + 3 : height - 1) * rowStride;
+        for (int x = x0; x < x1; x++) {
+            cur[x] = g->b * cur[x] + g->a1 * n1[x] + g->a2 * n2[x] + g->a3 * n3[x];
+        }
+    }
+}
+
+/**
+Table d'égalisation d'une tuile CLAHE à partir de son histogramme (modifié en place)
+- Les niveaux au-delà de clipLimit x count / 256 sont écrêtés, l'excédent est réparti
+  sur les 256 niveaux (reste : un niveau sur 256 / reste)
+- lut[i] = CDF(i) x 255 / count, arrondi
+*/
+void claheMapping(unsigned int *hist, unsigned int count, float clipLimit, unsigned char *lut) {
+    if (count == 0) {
+        for (int i = 0; i < 256; i++) lut[i] = (unsigned char)i;
+        return;
+    }
+
+    if (clipLimit > 0.0f) {
+        unsigned int limit = (unsigned int)(clipLimit * count / 256.0f);
+        if (limit < 1) limit = 1;
+
+        unsigned int excess = 0;
+        for (int i = 0; i < 256; i++) {
+            if (hist[i] > limit) {
+                excess += hist[i] - limit;
+                hist[i] = limit;
+            }
+        }
+
+        unsigned int share = excess / 256;
+        unsigned int residual = excess % 256;
+        for (int i = 0; i < 256; i++) hist[i] += share;
+        if (residual > 0) {
+            int step = 256 / residual;
+            for (int i = 0; i < 256 && residual > 0; i += step, residual--) hist[i]++;
+        }
+    }
+
+    unsigned int cum = 0;
+    for (int i = 0; i < 256; i++) {
+        cum += hist[i];
+        lut[i] = (unsigned char)(((uint64_t)cum * 255 + count / 2) / count);
+    }
+}
+
+/**
+Interpolation entre tuiles le long d'un axe de size pixels découpé en tiles tuiles
+- Centre de la tuile i : (i + 0.5) x size / tiles
+- first[k] : tuile dont le centre précède k (bornée à [0, tiles - 1]), la suivante est first[k] + 1
+  (bornée elle aussi) ; weight[k] : poids de la suivante, de 0 à 2^CLAHE_WEIGHT_BITS
+- Avant le premier centre et après le dernier : une seule tuile (poids 0)
+*/
+void claheAxis(int size, int tiles, int *first, int *weight) {
+    int one = 1 << CLAHE_WEIGHT_BITS;
+    for (int k = 0; k < size; k++) {
+        double f = (k + 0.5) * tiles / size - 0.5;
+        if (f <= 0.0) {
+            first[k] = 0;
+            weight[k] = 0;
+        } else if (f >= tiles - 1) {
+            first[k] = tiles - 1;
+            weight[k] = 0;
+        } else {
+            first[k] = (int)f;
+            weight[k] = (int)((f - first[k]) * one + 0.5);
+        }
     }
-    free(kernel);
 }
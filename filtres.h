@@ -1,6 +1,11 @@
 #ifndef FILTRES_H
 #define FILTRES_H
 
+#include <stddef.h>
+#include <stdint.h>
+
+// Matrices float ** (un seul bloc mémoire, libéré par freeKernel)
+float **allocateKernelMatrix(int size);
 float **createBoxBlurKernel();
 float **createGaussianBlurKernel();
 float **createOutlineKernel();
@@ -8,4 +13,135 @@ float **createEmbossKernel();
 float **createSharpenKernel();
 void freeKernel(float **kernel);
 
+// Noyaux séparables (rang 1) : noyau[i][j] = colKernel[i] * rowKernel[j]
+int separateKernel(float **kernel, int kernelSize, float *rowKernel, float *colKernel);
+
+// Forme entière exacte : kernel[i][j] = weights[i * kernelSize + j] / divisor
+// Retourne divisor (entre 1 et KERNEL_MAX_DIVISOR), ou 0 si le noyau n'est pas rationnel
+#define KERNEL_MAX_DIVISOR 65536
+int kernelToInteger(float **kernel, int kernelSize, int32_t *weights);
+int vectorToInteger(const float *values, int count, int32_t *weights);
+// Facteurs séparables entiers : noyau = intCol[i] * intRow[j] / divisor, 0 si impossible
+#define KERNEL_MAX_SEPARABLE_DIVISOR (1 << 20)
+int separableToInteger(const float *rowKernel, const float *colKernel, int kernelSize,
+                       int32_t *intRow, int32_t *intCol);
+
+// Division arrondie par un diviseur constant, par multiplication et décalage (sans division)
+// kernelDivide(d, sum) = sum / divisor arrondi au plus proche, borné à [0, 255]
+// (même arrondi que le calcul flottant : (int)(sum / divisor + 0.5))
+typedef struct {
+    int32_t divisor;
+    int32_t limit;          // sum >= limit : résultat 255
+    uint64_t multiplier;
+    int shift;
+} t_kernelDivider;
+
+void kernelDividerInit(t_kernelDivider *d, int32_t divisor);
+
+static inline uint8_t kernelDivide(const t_kernelDivider *d, int32_t sum) {
+    if (sum <= 0) return 0;
+    if (sum >= d->limit) return 255;
+    return (uint8_t)(((uint64_t)(2 * sum + d->divisor) * d->multiplier) >> d->shift);
+}
+
+// Coefficient non nul d'un noyau, avec sa position par rapport au centre
+typedef struct {
+    int dy;
+    int dx;
+    int32_t weight;             // forme entière (si divisor != 0)
+    float value;
+} t_kernelTap;
+
+// Noyau de convolution de taille impaire quelconque, alloué en un seul bloc
+// Les métadonnées sont calculées une fois à la création et servent à choisir le calcul :
+// - values / rows : coefficients (rows[i][j] : vue float ** pour les fonctions historiques)
+// - sum, zeroTaps, symmetric (symétrie miroir horizontale et verticale)
+// - separable : rowKernel / colKernel valides (noyau[i][j] = colKernel[i] * rowKernel[j])
+// - divisor : forme entière exacte (weights / divisor), 0 si le noyau n'est pas rationnel
+// - separableDivisor : facteurs entiers (intCol[i] * intRow[j] / separableDivisor), 0 sinon
+// - fixedDivisor : 3x3 rationnel à poids entiers 16 bits (fixed / fixedDivisor, égal à divisor)
+//   pour le chemin vectorisé exact (voir simd_convolve3x3), 0 sinon
+// - taps : coefficients non nuls seulement (tapCount)
+typedef struct {
+    int size;
+    int radius;
+    float sum;
+    int zeroTaps;
+    int symmetric;
+    int separable;
+    int32_t divisor;
+    int32_t separableDivisor;
+    int32_t fixedDivisor;
+    int tapCount;
+    float **rows;
+    float *values;
+    float *rowKernel;
+    float *colKernel;
+    int32_t *weights;
+    int32_t *intRow;
+    int32_t *intCol;
+    int16_t *fixed;
+    t_kernelTap *taps;
+} t_kernel;
+
+t_kernel *createKernel(int size, const float *values);
+t_kernel *createKernelFromMatrix(float **matrix, int size);
+// Rayon maximal des flous moyens par sommes glissantes : (2R + 1)² <= 2^22,
+// sommes (255 (2R + 1)²) et division arrondie exactes sur 32 bits
+#define KERNEL_MAX_BOX_RADIUS 1023
+t_kernel *createBoxKernel(int radius);
+t_kernel *createGaussianKernel(int radius, float sigma);
+void destroyKernel(t_kernel *kernel);
+
+// Bords des convolutions : valeur des voisins situés hors de l'image
+// Les filtres travaillent sur une copie de l'image entourée d'un halo de la taille du rayon,
+// rempli selon le mode : la boucle de calcul lit tous les voisins sans tester les bords
+typedef enum {
+    BORDER_CLAMP,       // pixel du bord répété :         aaa|abcd|ddd
+    BORDER_REFLECT,     // miroir, bord non répété :      dcb|abcd|cba
+    BORDER_WRAP,        // image répétée :                bcd|abcd|abc
+    BORDER_CONSTANT     // niveau constant (value) :      vvv|abcd|vvv
+} t_borderMode;
+
+typedef struct {
+    t_borderMode mode;
+    int value;              // BORDER_CONSTANT : niveau (0 - 255) de toutes les composantes
+} t_border;
+
+// Mode commun à tous les filtres 8 et 24 bits (BORDER_CLAMP par défaut), choisi avant les traitements
+void borderSet(t_borderMode mode, int value);
+t_border borderGet(void);
+const char *borderModeName(t_borderMode mode);
+// Position dans [0, n) du voisin d'indice i (quelconque), -1 pour BORDER_CONSTANT hors de [0, n)
+int borderIndex(const t_border *border, int i, int n);
+// Ligne agrandie : dst = radius pixels de halo, les width pixels de src, radius pixels de halo
+// (pixelSize octets par pixel ; src NULL : ligne entièrement hors de l'image)
+void borderPadRow(const t_border *border, const uint8_t *src, uint8_t *dst, int width, int radius,
+                  int pixelSize);
+
+// Filtre gaussien récursif (Young - van Vliet, ordre 3) : coût par échantillon indépendant de sigma
+// w[n] = b x[n] + a1 w[n - 1] + a2 w[n - 2] + a3 w[n - 3], puis même récurrence en sens inverse
+// Bords : valeur du premier / dernier échantillon répétée
+#define RECURSIVE_GAUSSIAN_MIN_SIGMA 0.5f
+typedef struct {
+    float b;
+    float a1, a2, a3;
+} t_recursiveGaussian;
+
+int recursiveGaussianInit(t_recursiveGaussian *g, float sigma);
+void recursiveGaussianLine(const t_recursiveGaussian *g, float *values, int count, int stride);
+void recursiveGaussianColumns(const t_recursiveGaussian *g, float *plane, size_t rowStride, int height,
+                              int x0, int x1);
+
+// CLAHE (égalisation adaptative à contraste limité) : une table par tuile, interpolation bilinéaire
+// - claheMapping : histogramme écrêté à clipLimit x (moyenne par niveau), excédent redistribué,
+//   puis table d'égalisation de la tuile (clipLimit <= 0 : sans écrêtage)
+// - claheAxis : pour chaque position d'un axe, tuile de gauche (ou du haut) et poids de la suivante
+//   (sur 2^CLAHE_WEIGHT_BITS), d'après les centres des tuiles
+#define CLAHE_DEFAULT_TILES 8
+#define CLAHE_DEFAULT_CLIP 2.0f
+#define CLAHE_WEIGHT_BITS 8
+void claheMapping(unsigned int *hist, unsigned int count, float clipLimit, unsigned char *lut);
+void claheAxis(int size, int tiles, int *first, int *weight);
+
 #endif
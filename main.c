@@ -2,6 +2,10 @@
 #include <stdlib.h>
 #include "bmp8.h"
 #include "bmp24.h"
+#include "simd.h"
+#include "parallele.h"
+#include "memoire.h"
+#include "batch.h"
 
 /*
 Menu principal pour les images 8 bits (niveaux de gris)
@@ -130,12 +134,43 @@ void menu_bmp24() {
     bmp24_free(img);
 }
 
+/*
+Mode batch : traite les fichiers de la ligne de commande sans interaction
+- Retourne 0 si tous les fichiers ont été traités, 1 sinon
+*/
+static int run_batch(int argc, char **argv) {
+    t_batch_config config;
+    if (batch_parseArgs(argc, argv, &config) != 0) {
+        batch_freeConfig(&config);
+        return 1;
+    }
+
+    simd_init();
+    parallel_init(config.threads);
+    borderSet(config.border.mode, config.border.value);
+    memory_usePool((size_t)config.poolCache << 20);
+    int failures = batch_run(&config);
+    memory_usePool(0);
+    parallel_shutdown();
+
+    batch_freeConfig(&config);
+    return failures ? 1 : 0;
+}
+
 /*
 Fonction principale
-- Affiche le menu de sélection du type d'image
+- Avec des arguments : mode batch (voir batch_usage)
+- Sinon affiche le menu de sélection du type d'image
 - Lance le menu correspondant
 */
-int main() {
+int main(int argc, char **argv) {
+    if (argc > 1) {
+        return run_batch(argc, argv);
+    }
+
+    simd_init();        // choix SSE2/AVX2 selon le processeur
+    parallel_init(0);   // un thread par processeur (ou BMP_THREADS)
+
     int mode = 0;
     printf("=== MENU DE LANCEMENT ===\n");
     printf("1 - Utiliser une image BMP 8 bits (niveau de gris)\n");
@@ -151,5 +186,6 @@ int main() {
         printf("Choix invalide. Le programme va se fermer.\n");
     }
 
+    parallel_shutdown();
     return 0;
 }
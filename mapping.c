@@ -0,0 +1,51 @@
+#include <stdio.h>
+#include "mapping.h"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/*
+Projette un fichier entier en mémoire
+- MAP_PRIVATE : les écritures restent locales au processus (copie à l'écriture),
+  le fichier sur disque n'est jamais modifié
+- Retourne NULL si la projection est impossible (l'appelant se rabat sur une lecture classique)
+*/
+void *mapping_open(const char *filename, size_t *size) {
+#ifdef _WIN32
+    (void)filename;
+    (void)size;
+    return NULL;
+#else
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) return NULL;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+        close(fd);
+        return NULL;
+    }
+
+    void *addr = mmap(NULL, (size_t)st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);  // la projection reste valide après fermeture du descripteur
+    if (addr == MAP_FAILED) return NULL;
+
+    *size = (size_t)st.st_size;
+    return addr;
+#endif
+}
+
+/*
+Libère une projection obtenue avec mapping_open
+*/
+void mapping_close(void *addr, size_t size) {
+#ifndef _WIN32
+    if (addr) munmap(addr, size);
+#else
+    (void)addr;
+    (void)size;
+#endif
+}
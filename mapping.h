@@ -0,0 +1,11 @@
+#ifndef MAPPING_H
+#define MAPPING_H
+
+#include <stddef.h>
+
+// Projection d'un fichier en mémoire (copie à l'écriture)
+// Les pages ne sont lues sur le disque qu'au premier accès
+void *mapping_open(const char *filename, size_t *size);
+void mapping_close(void *addr, size_t size);
+
+#endif
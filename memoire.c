@@ -0,0 +1,211 @@
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <pthread.h>
+#include "memoire.h"
+
+/*
+En-tête placé juste avant chaque bloc rendu par memory_alloc (MEMORY_ALIGNMENT octets réservés)
+- allocator : allocateur qui a fourni le bloc, size : taille demandée (en-tête compris)
+*/
+typedef struct {
+    t_allocator allocator;
+    size_t size;
+} t_memory_header;
+
+/*
+Allocateur système : bloc aligné sur MEMORY_ALIGNMENT octets
+*/
+static void *memory_systemAlloc(void *ctx, size_t size) {
+    (void)ctx;
+#ifdef _WIN32
+    return _aligned_malloc(size, MEMORY_ALIGNMENT);
+#else
+    void *ptr = NULL;
+    if (posix_memalign(&ptr, MEMORY_ALIGNMENT, size) != 0) return NULL;
+    return ptr;
+#endif
+}
+
+static void memory_systemRelease(void *ctx, void *block, size_t size) {
+    (void)ctx;
+    (void)size;
+#ifdef _WIN32
+    _aligned_free(block);
+#else
+    free(block);
+#endif
+}
+
+static const t_allocator memory_system = {memory_systemAlloc, memory_systemRelease, NULL};
+
+// Classes de taille : 64 octets, puis 4 classes par puissance de 2 (au plus 25 % de perte)
+#define MEMORY_POOL_MIN_SHIFT 6
+#define MEMORY_POOL_MAX_SHIFT 36
+#define MEMORY_POOL_CLASSES (1 + 4 * (MEMORY_POOL_MAX_SHIFT - MEMORY_POOL_MIN_SHIFT))
+
+/*
+Pool par classes de taille
+- free : liste des blocs libres de chaque classe, chaînés par leur premier mot
+- Un seul verrou : les allocations se font par image ou par filtre, pas par pixel
+*/
+typedef struct {
+    pthread_mutex_t lock;
+    void *free[MEMORY_POOL_CLASSES];
+    size_t maxCached;
+    t_memoryStats stats;
+} t_memory_pool;
+
+static t_memory_pool memory_pool = {PTHREAD_MUTEX_INITIALIZER};
+
+/*
+Classe d'une taille (ou -1 si elle dépasse la plus grande classe)
+- Arrondi au multiple supérieur du quart de la puissance de 2 qui la contient
+*/
+static int memory_sizeClass(size_t size) {
+    if (size <= ((size_t)1 << MEMORY_POOL_MIN_SHIFT)) return 0;
+    int e = 0;
+    for (size_t v = size - 1; v > 1; v >>= 1) e++;  // bit de poids fort de size - 1
+    if (e >= MEMORY_POOL_MAX_SHIFT) return -1;
+    size_t quarter = (size - 1) >> (e - 2);         // dans [4, 7]
+    return 1 + 4 * (e - MEMORY_POOL_MIN_SHIFT) + (int)(quarter - 4);
+}
+
+// Taille des blocs d'une classe (inverse de memory_sizeClass)
+static size_t memory_classSize(int sizeClass) {
+    if (sizeClass == 0) return (size_t)1 << MEMORY_POOL_MIN_SHIFT;
+    int e = MEMORY_POOL_MIN_SHIFT + (sizeClass - 1) / 4;
+    return (size_t)(5 + (sizeClass - 1) % 4) << (e - 2);
+}
+
+/*
+Rend au système tous les blocs en cache (sous verrou)
+*/
+static void memory_poolFlush(void) {
+    for (int c = 0; c < MEMORY_POOL_CLASSES; c++) {
+        while (memory_pool.free[c]) {
+            void *block = memory_pool.free[c];
+            memory_pool.free[c] = *(void **)block;
+            memory_systemRelease(NULL, block, memory_classSize(c));
+        }
+    }
+    memory_pool.stats.cachedBytes = 0;
+}
+
+/*
+Prend un bloc de la classe de size dans le cache, ou en alloue un de la taille de la classe
+*/
+static void *memory_poolAlloc(void *ctx, size_t size) {
+    (void)ctx;
+    int c = memory_sizeClass(size);
+    if (c < 0) return memory_systemAlloc(NULL, size);
+
+    pthread_mutex_lock(&memory_pool.lock);
+    memory_pool.stats.allocations++;
+    void *block = memory_pool.free[c];
+    if (block) {
+        memory_pool.free[c] = *(void **)block;
+        memory_pool.stats.cachedBytes -= memory_classSize(c);
+        memory_pool.stats.reused++;
+    }
+    pthread_mutex_unlock(&memory_pool.lock);
+    return block ? block : memory_systemAlloc(NULL, memory_classSize(c));
+}
+
+/*
+Garde le bloc en cache, ou le rend au système si le cache est plein
+*/
+static void memory_poolRelease(void *ctx, void *block, size_t size) {
+    (void)ctx;
+    int c = memory_sizeClass(size);
+    if (c >= 0) {
+        size_t bytes = memory_classSize(c);
+        pthread_mutex_lock(&memory_pool.lock);
+        int kept = memory_pool.stats.cachedBytes + bytes <= memory_pool.maxCached;
+        if (kept) {
+            *(void **)block = memory_pool.free[c];
+            memory_pool.free[c] = block;
+            memory_pool.stats.cachedBytes += bytes;
+            if (memory_pool.stats.cachedBytes > memory_pool.stats.peakCachedBytes) {
+                memory_pool.stats.peakCachedBytes = memory_pool.stats.cachedBytes;
+            }
+        }
+        pthread_mutex_unlock(&memory_pool.lock);
+        if (kept) return;
+    }
+    memory_systemRelease(NULL, block, size);
+}
+
+static const t_allocator memory_poolAllocator = {memory_poolAlloc, memory_poolRelease, NULL};
+
+// Allocateur courant (copie : l'appelant peut passer une structure temporaire)
+static t_allocator memory_current = {memory_systemAlloc, memory_systemRelease, NULL};
+
+/*
+Change l'allocateur courant
+- À appeler hors des traitements (comme parallel_init ou borderSet)
+*/
+void memory_setAllocator(const t_allocator *allocator) {
+    memory_current = allocator ? *allocator : memory_system;
+}
+
+/*
+Active le pool par classes de taille avec un cache d'au plus maxCached octets
+- maxCached = 0 : vide le cache et revient à l'allocateur système ; les blocs encore utilisés
+  sont rendus au système à leur libération
+*/
+void memory_usePool(size_t maxCached) {
+    pthread_mutex_lock(&memory_pool.lock);
+    memory_pool.maxCached = maxCached;
+    if (memory_pool.stats.cachedBytes > maxCached) memory_poolFlush();
+    pthread_mutex_unlock(&memory_pool.lock);
+    memory_setAllocator(maxCached ? &memory_poolAllocator : NULL);
+}
+
+/*
+Rend au système les blocs gardés en cache par le pool
+*/
+void memory_trim(void) {
+    pthread_mutex_lock(&memory_pool.lock);
+    memory_poolFlush();
+    pthread_mutex_unlock(&memory_pool.lock);
+}
+
+void memory_getStats(t_memoryStats *stats) {
+    pthread_mutex_lock(&memory_pool.lock);
+    *stats = memory_pool.stats;
+    pthread_mutex_unlock(&memory_pool.lock);
+}
+
+/*
+Alloue size octets alignés sur MEMORY_ALIGNMENT avec l'allocateur courant
+- Un en-tête de MEMORY_ALIGNMENT octets précède le bloc (allocateur d'origine et taille)
+*/
+void *memory_alloc(size_t size) {
+    if (size > SIZE_MAX - MEMORY_ALIGNMENT) return NULL;
+    size_t total = size + MEMORY_ALIGNMENT;
+    uint8_t *block = memory_current.alloc(memory_current.ctx, total);
+    if (!block) return NULL;
+
+    t_memory_header *header = (t_memory_header *)block;
+    header->allocator = memory_current;
+    header->size = total;
+    return block + MEMORY_ALIGNMENT;
+}
+
+void *memory_calloc(size_t count, size_t size) {
+    if (size && count > SIZE_MAX / size) return NULL;
+    void *ptr = memory_alloc(count * size);
+    if (ptr) memset(ptr, 0, count * size);
+    return ptr;
+}
+
+/*
+Rend un bloc de memory_alloc à l'allocateur qui l'a fourni
+*/
+void memory_free(void *ptr) {
+    if (ptr == NULL) return;
+    uint8_t *block = (uint8_t *)ptr - MEMORY_ALIGNMENT;
+    t_memory_header header = *(t_memory_header *)block;
+    header.allocator.release(header.allocator.ctx, block, header.size);
+}
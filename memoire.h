@@ -0,0 +1,47 @@
+#ifndef MEMOIRE_H
+#define MEMOIRE_H
+
+#include <stddef.h>
+
+// Alignement de tous les blocs rendus par memory_alloc (une ligne de cache, assez pour AVX2)
+#define MEMORY_ALIGNMENT 64
+
+// Cache par défaut du pool en mode batch (Mo)
+#define MEMORY_POOL_DEFAULT_CACHE_MB 256
+
+// Allocateur des images, buffers de travail et noyaux (bmp8, bmp24, filtres)
+// - Les histogrammes et CDF retournés restent alloués par malloc (à libérer par free)
+// - alloc : bloc d'au moins size octets aligné sur MEMORY_ALIGNMENT, NULL en cas d'échec
+// - release : rend un bloc obtenu par alloc (size : taille demandée à alloc)
+// - ctx : passé tel quel aux deux fonctions
+typedef struct {
+    void *(*alloc)(void *ctx, size_t size);
+    void (*release)(void *ctx, void *block, size_t size);
+    void *ctx;
+} t_allocator;
+
+// Compteurs du pool (voir memory_usePool)
+typedef struct {
+    size_t allocations;         // blocs demandés au pool
+    size_t reused;              // blocs repris dans le cache (sans appel au système)
+    size_t cachedBytes;         // octets gardés en cache
+    size_t peakCachedBytes;
+} t_memoryStats;
+
+// Change l'allocateur des prochaines allocations (NULL : allocateur système)
+// L'allocateur doit rester valide tant que des blocs qu'il a fournis ne sont pas libérés
+// (chaque bloc est rendu à l'allocateur qui l'a fourni, même après un changement)
+void memory_setAllocator(const t_allocator *allocator);
+
+// Pool par classes de taille : les blocs libérés sont gardés (jusqu'à maxCached octets)
+// et réutilisés pour les demandes de même classe ; maxCached = 0 : retour à l'allocateur système
+void memory_usePool(size_t maxCached);
+void memory_trim(void);
+void memory_getStats(t_memoryStats *stats);
+
+// Allocation par l'allocateur courant ; memory_free accepte NULL
+void *memory_alloc(size_t size);
+void *memory_calloc(size_t count, size_t size);
+void memory_free(void *ptr);
+
+#endif
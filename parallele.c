@@ -0,0 +1,209 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include "parallele.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+// Nombre de tuiles par thread : équilibre la charge sans trop de synchronisation
+#define PARALLEL_TILES_PER_THREAD 4
+
+typedef struct {
+    pthread_t *threads;
+    int count;              // nombre total de threads (appelant compris)
+    pthread_mutex_t lock;
+    pthread_cond_t wake;
+    pthread_cond_t done;
+    pthread_mutex_t busy;   // un seul parallel_for à la fois sur le pool
+
+    // Travail en cours
+    t_parallel_task task;
+    void *ctx;
+    int total;
+    int tileSize;
+    int nextStart;
+    int running;            // threads du pool encore en train de travailler
+    unsigned int generation;
+    int stop;
+} t_parallel_pool;
+
+static t_parallel_pool pool = {NULL, 1};
+
+typedef struct {
+    int worker;
+} t_parallel_worker;
+
+/*
+Prend la prochaine tuile à traiter (sous verrou)
+- Retourne 0 quand il n'y a plus rien à prendre
+*/
+static int parallel_takeTile(int *start, int *stop) {
+    pthread_mutex_lock(&pool.lock);
+    int taken = pool.nextStart < pool.total;
+    if (taken) {
+        *start = pool.nextStart;
+        *stop = (pool.nextStart + pool.tileSize < pool.total) ? pool.nextStart + pool.tileSize : pool.total;
+        pool.nextStart = *stop;
+    }
+    pthread_mutex_unlock(&pool.lock);
+    return taken;
+}
+
+static void *parallel_workerMain(void *arg) {
+    int worker = ((t_parallel_worker *)arg)->worker;
+    free(arg);
+
+    unsigned int seen = 0;
+    for (;;) {
+        pthread_mutex_lock(&pool.lock);
+        while (!pool.stop && pool.generation == seen) {
+            pthread_cond_wait(&pool.wake, &pool.lock);
+        }
+        if (pool.stop) {
+            pthread_mutex_unlock(&pool.lock);
+            break;
+        }
+        seen = pool.generation;
+        pthread_mutex_unlock(&pool.lock);
+
+        int start, stop;
+        while (parallel_takeTile(&start, &stop)) {
+            pool.task(pool.ctx, start, stop, worker);
+        }
+
+        pthread_mutex_lock(&pool.lock);
+        if (--pool.running == 0) pthread_cond_signal(&pool.done);
+        pthread_mutex_unlock(&pool.lock);
+    }
+    return NULL;
+}
+
+/*
+Nombre de processeurs logiques de la machine
+*/
+static int parallel_cpuCount(void) {
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return (int)info.dwNumberOfProcessors;
+#else
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return n > 0 ? (int)n : 1;
+#endif
+}
+
+/*
+Démarre le pool de threads
+- threads <= 0 : BMP_THREADS si défini, sinon nombre de processeurs
+- L'appelant de parallel_for travaille aussi : le pool crée threads - 1 threads
+*/
+void parallel_init(int threads) {
+    if (pool.threads) return;
+
+    if (threads <= 0) {
+        const char *env = getenv("BMP_THREADS");
+        threads = env ? atoi(env) : 0;
+    }
+    if (threads <= 0) threads = parallel_cpuCount();
+    if (threads <= 1) return;
+
+    pthread_mutex_init(&pool.lock, NULL);
+    pthread_mutex_init(&pool.busy, NULL);
+    pthread_cond_init(&pool.wake, NULL);
+    pthread_cond_init(&pool.done, NULL);
+    pool.stop = 0;
+    pool.generation = 0;
+
+    pool.threads = malloc((threads - 1) * sizeof(pthread_t));
+    if (!pool.threads) return;
+
+    pool.count = 1;
+    for (int i = 0; i < threads - 1; i++) {
+        t_parallel_worker *arg = malloc(sizeof(t_parallel_worker));
+        if (!arg) break;
+        arg->worker = i + 1;
+        if (pthread_create(&pool.threads[i], NULL, parallel_workerMain, arg) != 0) {
+            free(arg);
+            break;
+        }
+        pool.count++;
+    }
+}
+
+/*
+Arrête et attend tous les threads du pool
+*/
+void parallel_shutdown(void) {
+    if (!pool.threads) return;
+
+    pthread_mutex_lock(&pool.lock);
+    pool.stop = 1;
+    pthread_cond_broadcast(&pool.wake);
+    pthread_mutex_unlock(&pool.lock);
+
+    for (int i = 0; i < pool.count - 1; i++) {
+        pthread_join(pool.threads[i], NULL);
+    }
+    free(pool.threads);
+    pool.threads = NULL;
+    pool.count = 1;
+
+    pthread_mutex_destroy(&pool.lock);
+    pthread_mutex_destroy(&pool.busy);
+    pthread_cond_destroy(&pool.wake);
+    pthread_cond_destroy(&pool.done);
+}
+
+int parallel_getThreadCount(void) {
+    return pool.count;
+}
+
+/*
+Répartit [0, count) en tuiles sur le pool et attend la fin
+- Chaque élément est traité par exactement une tâche : le résultat ne dépend
+  pas du découpage tant que les tâches n'écrivent que dans leurs propres éléments
+- Pool absent, petit travail ou pool déjà occupé (appel imbriqué, autre thread) :
+  tout est exécuté par l'appelant, avec worker = 0
+*/
+void parallel_for(int count, int grain, t_parallel_task task, void *ctx) {
+    if (count <= 0) return;
+    if (grain < 1) grain = 1;
+
+    if (!pool.threads || count <= grain || pthread_mutex_trylock(&pool.busy) != 0) {
+        task(ctx, 0, count, 0);
+        return;
+    }
+
+    int tiles = pool.count * PARALLEL_TILES_PER_THREAD;
+    int tileSize = (count + tiles - 1) / tiles;
+    if (tileSize < grain) tileSize = grain;
+
+    pthread_mutex_lock(&pool.lock);
+    pool.task = task;
+    pool.ctx = ctx;
+    pool.total = count;
+    pool.tileSize = tileSize;
+    pool.nextStart = 0;
+    pool.running = pool.count - 1;
+    pool.generation++;
+    pthread_cond_broadcast(&pool.wake);
+    pthread_mutex_unlock(&pool.lock);
+
+    // L'appelant traite aussi des tuiles (worker 0)
+    int start, stop;
+    while (parallel_takeTile(&start, &stop)) {
+        task(ctx, start, stop, 0);
+    }
+
+    pthread_mutex_lock(&pool.lock);
+    while (pool.running > 0) {
+        pthread_cond_wait(&pool.done, &pool.lock);
+    }
+    pthread_mutex_unlock(&pool.lock);
+
+    pthread_mutex_unlock(&pool.busy);
+}
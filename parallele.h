@@ -0,0 +1,18 @@
+#ifndef PARALLELE_H
+#define PARALLELE_H
+
+// Tâche exécutée sur les éléments [start, stop) (en général des lignes d'image)
+// worker : numéro du thread, dans [0, parallel_getThreadCount()), pour les buffers de travail
+typedef void (*t_parallel_task)(void *ctx, int start, int stop, int worker);
+
+// Pool de threads partagé par les filtres
+// threads <= 0 : variable d'environnement BMP_THREADS, sinon nombre de processeurs
+void parallel_init(int threads);
+void parallel_shutdown(void);
+int parallel_getThreadCount(void);
+
+// Découpe [0, count) en tuiles d'au moins grain éléments et les répartit sur le pool
+// Retourne quand toutes les tuiles sont traitées. Sans pool (ou pool occupé), exécution directe.
+void parallel_for(int count, int grain, t_parallel_task task, void *ctx);
+
+#endif
@@ -0,0 +1,767 @@
+#include <string.h>
+#include "simd.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define SIMD_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+// Les fonctions AVX2 / SSSE3 sont compilées pour leur cible même si le reste
+// du programme ne l'est pas : elles ne sont appelées qu'après détection
+#if defined(__GNUC__)
+#define SIMD_TARGET(t) __attribute__((target(t)))
+#else
+#define SIMD_TARGET(t)
+#endif
+
+/* ---------------------------------------------------------------------------
+   Versions scalaires (référence et repli)
+   --------------------------------------------------------------------------- */
+
+static void negate_scalar(uint8_t *data, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        data[i] = 255 - data[i];
+    }
+}
+
+static void addSaturate_scalar(uint8_t *data, size_t n, int value) {
+    for (size_t i = 0; i < n; i++) {
+        int pixel = data[i] + value;
+        if (pixel > 255) pixel = 255;
+        if (pixel < 0) pixel = 0;
+        data[i] = (uint8_t)pixel;
+    }
+}
+
+static void threshold_scalar(uint8_t *data, size_t n, int threshold) {
+    for (size_t i = 0; i < n; i++) {
+        data[i] = (data[i] >= threshold) ? 255 : 0;
+    }
+}
+
+static void grayscale3_scalar(uint8_t *pixels, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        uint8_t *p = pixels + 3 * i;
+        uint8_t gray = (p[0] + p[1] + p[2]) / 3;
+        p[0] = p[1] = p[2] = gray;
+    }
+}
+
+static void deinterleave3_scalar(const uint8_t *pixels, uint8_t *c0, uint8_t *c1, uint8_t *c2, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        c0[i] = pixels[3 * i];
+        c1[i] = pixels[3 * i + 1];
+        c2[i] = pixels[3 * i + 2];
+    }
+}
+
+static void interleave3_scalar(const uint8_t *c0, const uint8_t *c1, const uint8_t *c2, uint8_t *pixels, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        pixels[3 * i] = c0[i];
+        pixels[3 * i + 1] = c1[i];
+        pixels[3 * i + 2] = c2[i];
+    }
+}
+
+static void compact4to3_scalar(const uint8_t *src, uint8_t *dst, uint8_t *alpha, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        dst[3 * i] = src[4 * i];
+        dst[3 * i + 1] = src[4 * i + 1];
+        dst[3 * i + 2] = src[4 * i + 2];
+        if (alpha) alpha[i] = src[4 * i + 3];
+    }
+}
+
+static void expand3to4_scalar(const uint8_t *src, const uint8_t *alpha, uint8_t *dst, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        dst[4 * i] = src[3 * i];
+        dst[4 * i + 1] = src[3 * i + 1];
+        dst[4 * i + 2] = src[3 * i + 2];
+        dst[4 * i + 3] = alpha ? alpha[i] : 255;
+    }
+}
+
+static void average3_scalar(const uint8_t *a, const uint8_t *b, const uint8_t *c, uint8_t *dst, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        dst[i] = (uint8_t)((a[i] + b[i] + c[i]) / 3);
+    }
+}
+
+/*
+Division arrondie des sommes de la convolution 3x3 par un diviseur D >= 1
+- shift >= 0 : D = 2^shift, (somme + D / 2) >> shift
+- sinon multiplication 32 x 32 -> 64 bits et décalage : floor(N * multiplier / 2^mulShift)
+  = floor(N / 2D) avec N = 2 somme + D, exact pour toute somme donnant au plus 256
+  (2^mulShift >= 1024 D², voir convolve3x3_divisor) ; au-delà le résultat reste >= 256 et
+  sature à 255, comme kernelDivide dans filtres.h
+*/
+typedef struct {
+    int32_t divisor;
+    int shift;
+    uint32_t multiplier;
+    int mulShift;
+} t_simd_divisor;
+
+static t_simd_divisor convolve3x3_divisor(int32_t divisor) {
+    t_simd_divisor d;
+    d.divisor = divisor < 1 ? 1 : divisor;
+    d.shift = -1;
+    d.multiplier = 0;
+    d.mulShift = 0;
+    if ((d.divisor & (d.divisor - 1)) == 0) {
+        d.shift = 0;
+        while ((1 << d.shift) < d.divisor) d.shift++;
+        return d;
+    }
+    uint64_t square = 1024 * (uint64_t)d.divisor * (uint64_t)d.divisor;
+    while (((uint64_t)1 << d.mulShift) < square) d.mulShift++;
+    uint64_t twice = 2 * (uint64_t)d.divisor;
+    d.multiplier = (uint32_t)((((uint64_t)1 << d.mulShift) + twice - 1) / twice);
+    return d;
+}
+
+/*
+Convolution 3x3 entière (référence) : pour chaque x de [0, n)
+  dst[x] = clamp(somme des rk[x + j step] * w[3k + j] / divisor, arrondi au plus proche)
+Les versions SIMD donnent exactement les mêmes valeurs
+*/
+static void convolve3x3_scalar(const uint8_t *r0, const uint8_t *r1, const uint8_t *r2,
+                               uint8_t *dst, size_t n, size_t step, const int16_t *w, int32_t divisor) {
+    int64_t twice = 2 * (int64_t)(divisor < 1 ? 1 : divisor);
+    for (size_t x = 0; x < n; x++) {
+        int32_t acc = r0[x] * w[0] + r0[x + step] * w[1] + r0[x + 2 * step] * w[2]
+                    + r1[x] * w[3] + r1[x + step] * w[4] + r1[x + 2 * step] * w[5]
+                    + r2[x] * w[6] + r2[x + step] * w[7] + r2[x + 2 * step] * w[8];
+        int64_t value = acc <= 0 ? 0 : (2 * (int64_t)acc + twice / 2) / twice;
+        dst[x] = (uint8_t)(value > 255 ? 255 : value);
+    }
+}
+
+#ifdef SIMD_X86
+
+/* ---------------------------------------------------------------------------
+   SSE2 : 16 octets par itération
+   --------------------------------------------------------------------------- */
+
+static void negate_sse2(uint8_t *data, size_t n) {
+    const __m128i ones = _mm_set1_epi8((char)0xFF);
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i *)(data + i));
+        _mm_storeu_si128((__m128i *)(data + i), _mm_xor_si128(v, ones));
+    }
+    negate_scalar(data + i, n - i);
+}
+
+static void addSaturate_sse2(uint8_t *data, size_t n, int value) {
+    // Addition ou soustraction saturée selon le signe : pas de test par pixel
+    int magnitude = value < 0 ? -value : value;
+    if (magnitude > 255) magnitude = 255;
+    const __m128i delta = _mm_set1_epi8((char)magnitude);
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i *)(data + i));
+        v = value < 0 ? _mm_subs_epu8(v, delta) : _mm_adds_epu8(v, delta);
+        _mm_storeu_si128((__m128i *)(data + i), v);
+    }
+    addSaturate_scalar(data + i, n - i, value);
+}
+
+static void threshold_sse2(uint8_t *data, size_t n, int threshold) {
+    // v >= seuil <=> max(v, seuil) == v : le masque de comparaison est directement le résultat
+    const __m128i t = _mm_set1_epi8((char)threshold);
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i *)(data + i));
+        _mm_storeu_si128((__m128i *)(data + i), _mm_cmpeq_epi8(_mm_max_epu8(v, t), v));
+    }
+    threshold_scalar(data + i, n - i, threshold);
+}
+
+/*
+Convolution 3x3 SSE2 : 16 pixels par itération
+- Pixels élargis sur 16 bits, poids 16 bits associés par paires
+- pmaddwd : deux produits sommés sur 32 bits, 5 pmaddwd pour les 9 coefficients
+*/
+static __m128i convolve3x3_madd_sse2(__m128i acc, __m128i a, __m128i b, __m128i weights) {
+    return _mm_add_epi32(acc, _mm_madd_epi16(_mm_unpacklo_epi16(a, b), weights));
+}
+
+static __m128i convolve3x3_maddHi_sse2(__m128i acc, __m128i a, __m128i b, __m128i weights) {
+    return _mm_add_epi32(acc, _mm_madd_epi16(_mm_unpackhi_epi16(a, b), weights));
+}
+
+/*
+Division arrondie de 4 sommes 32 bits (voir t_simd_divisor)
+- Diviseur quelconque : sommes négatives ramenées à 0, produits 64 bits des voies paires
+  et impaires (pmuludq), décalés puis réentrelacés
+*/
+static __m128i convolve3x3_divide_sse2(__m128i acc, const t_simd_divisor *d) {
+    if (d->shift >= 0) {
+        __m128i round = _mm_set1_epi32(d->divisor >> 1);
+        return _mm_sra_epi32(_mm_add_epi32(acc, round), _mm_cvtsi32_si128(d->shift));
+    }
+    const __m128i multiplier = _mm_set1_epi32((int)d->multiplier);
+    const __m128i count = _mm_cvtsi32_si128(d->mulShift);
+    acc = _mm_andnot_si128(_mm_srai_epi32(acc, 31), acc);
+    __m128i num = _mm_add_epi32(_mm_add_epi32(acc, acc), _mm_set1_epi32(d->divisor));
+    __m128i even = _mm_srl_epi64(_mm_mul_epu32(num, multiplier), count);
+    __m128i odd = _mm_srl_epi64(_mm_mul_epu32(_mm_srli_epi64(num, 32), multiplier), count);
+    return _mm_or_si128(even, _mm_slli_epi64(odd, 32));
+}
+
+static void convolve3x3_sse2(const uint8_t *r0, const uint8_t *r1, const uint8_t *r2,
+                             uint8_t *dst, size_t n, size_t step, const int16_t *w, int32_t divisor) {
+    const uint8_t *rows[3] = {r0, r1, r2};
+    const __m128i zero = _mm_setzero_si128();
+    const t_simd_divisor d = convolve3x3_divisor(divisor);
+    __m128i pairs[5];
+    for (int k = 0; k < 5; k++) {
+        int16_t wb = (2 * k + 1 < 9) ? w[2 * k + 1] : 0;
+        pairs[k] = _mm_set1_epi32((int)(((uint32_t)(uint16_t)wb << 16) | (uint16_t)w[2 * k]));
+    }
+
+    size_t x = 0;
+    for (; x + 16 <= n; x += 16) {
+        __m128i taps[10];
+        for (int k = 0; k < 9; k++) {
+            taps[k] = _mm_loadu_si128((const __m128i *)(rows[k / 3] + x + (k % 3) * step));
+        }
+        taps[9] = zero;
+
+        // Deux moitiés de 8 pixels, chacune en deux accumulateurs de 4 pixels
+        __m128i out[2];
+        for (int half = 0; half < 2; half++) {
+            __m128i accLo = zero, accHi = zero;
+            for (int k = 0; k < 5; k++) {
+                __m128i a = half ? _mm_unpackhi_epi8(taps[2 * k], zero) : _mm_unpacklo_epi8(taps[2 * k], zero);
+                __m128i b = half ? _mm_unpackhi_epi8(taps[2 * k + 1], zero) : _mm_unpacklo_epi8(taps[2 * k + 1], zero);
+                accLo = convolve3x3_madd_sse2(accLo, a, b, pairs[k]);
+                accHi = convolve3x3_maddHi_sse2(accHi, a, b, pairs[k]);
+            }
+            out[half] = _mm_packs_epi32(convolve3x3_divide_sse2(accLo, &d), convolve3x3_divide_sse2(accHi, &d));
+        }
+        _mm_storeu_si128((__m128i *)(dst + x), _mm_packus_epi16(out[0], out[1]));
+    }
+    convolve3x3_scalar(r0 + x, r1 + x, r2 + x, dst + x, n - x, step, w, divisor);
+}
+
+// Moyenne de trois plans, 16 octets par itération (division par 3 comme grayscale3_ssse3)
+static void average3_sse2(const uint8_t *a, const uint8_t *b, const uint8_t *c, uint8_t *dst, size_t n) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i third = _mm_set1_epi16((short)0xAAAB);
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m128i va = _mm_loadu_si128((const __m128i *)(a + i));
+        __m128i vb = _mm_loadu_si128((const __m128i *)(b + i));
+        __m128i vc = _mm_loadu_si128((const __m128i *)(c + i));
+        __m128i lo = _mm_add_epi16(_mm_add_epi16(_mm_unpacklo_epi8(va, zero), _mm_unpacklo_epi8(vb, zero)),
+                                   _mm_unpacklo_epi8(vc, zero));
+        __m128i hi = _mm_add_epi16(_mm_add_epi16(_mm_unpackhi_epi8(va, zero), _mm_unpackhi_epi8(vb, zero)),
+                                   _mm_unpackhi_epi8(vc, zero));
+        lo = _mm_srli_epi16(_mm_mulhi_epu16(lo, third), 1);
+        hi = _mm_srli_epi16(_mm_mulhi_epu16(hi, third), 1);
+        _mm_storeu_si128((__m128i *)(dst + i), _mm_packus_epi16(lo, hi));
+    }
+    average3_scalar(a + i, b + i, c + i, dst + i, n - i);
+}
+
+/* ---------------------------------------------------------------------------
+   SSSE3 : niveaux de gris, 16 pixels (48 octets) par itération
+   - pshufb regroupe chaque composante dans un registre
+   - somme sur 16 bits, division par 3 exacte par multiplication : (s * 0xAAAB) >> 17
+   - pshufb redistribue la valeur grise sur les 3 composantes
+   --------------------------------------------------------------------------- */
+
+SIMD_TARGET("ssse3")
+static __m128i grayscale_gather(__m128i a, __m128i b, __m128i c, int channel) {
+    static const int8_t masks[3][3][16] = {
+        {   // composante 0
+            {0, 3, 6, 9, 12, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+            {-1, -1, -1, -1, -1, -1, 2, 5, 8, 11, 14, -1, -1, -1, -1, -1},
+            {-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 1, 4, 7, 10, 13}
+        },
+        {   // composante 1
+            {1, 4, 7, 10, 13, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+            {-1, -1, -1, -1, -1, 0, 3, 6, 9, 12, 15, -1, -1, -1, -1, -1},
+            {-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 2, 5, 8, 11, 14}
+        },
+        {   // composante 2
+            {2, 5, 8, 11, 14, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+            {-1, -1, -1, -1, -1, 1, 4, 7, 10, 13, -1, -1, -1, -1, -1, -1},
+            {-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 0, 3, 6, 9, 12, 15}
+        }
+    };
+    __m128i ra = _mm_shuffle_epi8(a, _mm_loadu_si128((const __m128i *)masks[channel][0]));
+    __m128i rb = _mm_shuffle_epi8(b, _mm_loadu_si128((const __m128i *)masks[channel][1]));
+    __m128i rc = _mm_shuffle_epi8(c, _mm_loadu_si128((const __m128i *)masks[channel][2]));
+    return _mm_or_si128(ra, _mm_or_si128(rb, rc));
+}
+
+SIMD_TARGET("ssse3")
+static void grayscale3_ssse3(uint8_t *pixels, size_t count) {
+    static const int8_t spread[3][16] = {
+        {0, 0, 0, 1, 1, 1, 2, 2, 2, 3, 3, 3, 4, 4, 4, 5},
+        {5, 5, 6, 6, 6, 7, 7, 7, 8, 8, 8, 9, 9, 9, 10, 10},
+        {10, 11, 11, 11, 12, 12, 12, 13, 13, 13, 14, 14, 14, 15, 15, 15}
+    };
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i third = _mm_set1_epi16((short)0xAAAB);
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        uint8_t *p = pixels + 3 * i;
+        __m128i a = _mm_loadu_si128((const __m128i *)p);
+        __m128i b = _mm_loadu_si128((const __m128i *)(p + 16));
+        __m128i c = _mm_loadu_si128((const __m128i *)(p + 32));
+
+        __m128i c0 = grayscale_gather(a, b, c, 0);
+        __m128i c1 = grayscale_gather(a, b, c, 1);
+        __m128i c2 = grayscale_gather(a, b, c, 2);
+
+        __m128i lo = _mm_add_epi16(_mm_add_epi16(_mm_unpacklo_epi8(c0, zero), _mm_unpacklo_epi8(c1, zero)),
+                                   _mm_unpacklo_epi8(c2, zero));
+        __m128i hi = _mm_add_epi16(_mm_add_epi16(_mm_unpackhi_epi8(c0, zero), _mm_unpackhi_epi8(c1, zero)),
+                                   _mm_unpackhi_epi8(c2, zero));
+        lo = _mm_srli_epi16(_mm_mulhi_epu16(lo, third), 1);
+        hi = _mm_srli_epi16(_mm_mulhi_epu16(hi, third), 1);
+        __m128i gray = _mm_packus_epi16(lo, hi);
+
+        _mm_storeu_si128((__m128i *)p, _mm_shuffle_epi8(gray, _mm_loadu_si128((const __m128i *)spread[0])));
+        _mm_storeu_si128((__m128i *)(p + 16), _mm_shuffle_epi8(gray, _mm_loadu_si128((const __m128i *)spread[1])));
+        _mm_storeu_si128((__m128i *)(p + 32), _mm_shuffle_epi8(gray, _mm_loadu_si128((const __m128i *)spread[2])));
+    }
+    grayscale3_scalar(pixels + 3 * i, count - i);
+}
+
+/* ---------------------------------------------------------------------------
+   SSSE3 : passage entre pixels de 3 octets et plans séparés, 16 pixels par itération
+   - vers les plans : les masques de grayscale_gather regroupent chaque composante
+   - vers les pixels : chaque registre de sortie réunit 3 plans remis en place par pshufb
+   --------------------------------------------------------------------------- */
+
+SIMD_TARGET("ssse3")
+static void deinterleave3_ssse3(const uint8_t *pixels, uint8_t *c0, uint8_t *c1, uint8_t *c2, size_t count) {
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        const uint8_t *p = pixels + 3 * i;
+        __m128i a = _mm_loadu_si128((const __m128i *)p);
+        __m128i b = _mm_loadu_si128((const __m128i *)(p + 16));
+        __m128i c = _mm_loadu_si128((const __m128i *)(p + 32));
+        _mm_storeu_si128((__m128i *)(c0 + i), grayscale_gather(a, b, c, 0));
+        _mm_storeu_si128((__m128i *)(c1 + i), grayscale_gather(a, b, c, 1));
+        _mm_storeu_si128((__m128i *)(c2 + i), grayscale_gather(a, b, c, 2));
+    }
+    deinterleave3_scalar(pixels + 3 * i, c0 + i, c1 + i, c2 + i, count - i);
+}
+
+SIMD_TARGET("ssse3")
+static void interleave3_ssse3(const uint8_t *c0, const uint8_t *c1, const uint8_t *c2, uint8_t *pixels, size_t count) {
+    static const int8_t masks[3][3][16] = {
+        {   // octets 0 à 15
+            {0, -1, -1, 1, -1, -1, 2, -1, -1, 3, -1, -1, 4, -1, -1, 5},
+            {-1, 0, -1, -1, 1, -1, -1, 2, -1, -1, 3, -1, -1, 4, -1, -1},
+            {-1, -1, 0, -1, -1, 1, -1, -1, 2, -1, -1, 3, -1, -1, 4, -1}
+        },
+        {   // octets 16 à 31
+            {-1, -1, 6, -1, -1, 7, -1, -1, 8, -1, -1, 9, -1, -1, 10, -1},
+            {5, -1, -1, 6, -1, -1, 7, -1, -1, 8, -1, -1, 9, -1, -1, 10},
+            {-1, 5, -1, -1, 6, -1, -1, 7, -1, -1, 8, -1, -1, 9, -1, -1}
+        },
+        {   // octets 32 à 47
+            {-1, 11, -1, -1, 12, -1, -1, 13, -1, -1, 14, -1, -1, 15, -1, -1},
+            {-1, -1, 11, -1, -1, 12, -1, -1, 13, -1, -1, 14, -1, -1, 15, -1},
+            {10, -1, -1, 11, -1, -1, 12, -1, -1, 13, -1, -1, 14, -1, -1, 15}
+        }
+    };
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __m128i a = _mm_loadu_si128((const __m128i *)(c0 + i));
+        __m128i b = _mm_loadu_si128((const __m128i *)(c1 + i));
+        __m128i c = _mm_loadu_si128((const __m128i *)(c2 + i));
+        uint8_t *p = pixels + 3 * i;
+        for (int k = 0; k < 3; k++) {
+            __m128i ra = _mm_shuffle_epi8(a, _mm_loadu_si128((const __m128i *)masks[k][0]));
+            __m128i rb = _mm_shuffle_epi8(b, _mm_loadu_si128((const __m128i *)masks[k][1]));
+            __m128i rc = _mm_shuffle_epi8(c, _mm_loadu_si128((const __m128i *)masks[k][2]));
+            _mm_storeu_si128((__m128i *)(p + 16 * k), _mm_or_si128(ra, _mm_or_si128(rb, rc)));
+        }
+    }
+    interleave3_scalar(c0 + i, c1 + i, c2 + i, pixels + 3 * i, count - i);
+}
+
+/* ---------------------------------------------------------------------------
+   SSSE3 : passage entre pixels de 4 octets (BGRX / BGRA) et de 3 octets, 16 pixels par itération
+   - vers 3 octets : pshufb tasse les 12 octets utiles de chaque registre, les décalages
+     d'octets les mettent bout à bout (64 octets lus, 48 écrits), le 4e octet va dans alpha
+   - vers 4 octets : chaque groupe de 12 octets est amené en tête (palignr), puis étalé
+   --------------------------------------------------------------------------- */
+
+SIMD_TARGET("ssse3")
+static void compact4to3_ssse3(const uint8_t *src, uint8_t *dst, uint8_t *alpha, size_t count) {
+    const __m128i pack = _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+    const __m128i fourth = _mm_setr_epi8(3, 7, 11, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        const uint8_t *p = src + 4 * i;
+        __m128i a = _mm_loadu_si128((const __m128i *)p);
+        __m128i b = _mm_loadu_si128((const __m128i *)(p + 16));
+        __m128i c = _mm_loadu_si128((const __m128i *)(p + 32));
+        __m128i d = _mm_loadu_si128((const __m128i *)(p + 48));
+        __m128i pa = _mm_shuffle_epi8(a, pack);
+        __m128i pb = _mm_shuffle_epi8(b, pack);
+        __m128i pc = _mm_shuffle_epi8(c, pack);
+        __m128i pd = _mm_shuffle_epi8(d, pack);
+        uint8_t *q = dst + 3 * i;
+        _mm_storeu_si128((__m128i *)q, _mm_or_si128(pa, _mm_slli_si128(pb, 12)));
+        _mm_storeu_si128((__m128i *)(q + 16), _mm_or_si128(_mm_srli_si128(pb, 4), _mm_slli_si128(pc, 8)));
+        _mm_storeu_si128((__m128i *)(q + 32), _mm_or_si128(_mm_srli_si128(pc, 8), _mm_slli_si128(pd, 4)));
+        if (alpha) {
+            __m128i ab = _mm_unpacklo_epi32(_mm_shuffle_epi8(a, fourth), _mm_shuffle_epi8(b, fourth));
+            __m128i cd = _mm_unpacklo_epi32(_mm_shuffle_epi8(c, fourth), _mm_shuffle_epi8(d, fourth));
+            _mm_storeu_si128((__m128i *)(alpha + i), _mm_unpacklo_epi64(ab, cd));
+        }
+    }
+    compact4to3_scalar(src + 4 * i, dst + 3 * i, alpha ? alpha + i : NULL, count - i);
+}
+
+SIMD_TARGET("ssse3")
+static void expand3to4_ssse3(const uint8_t *src, const uint8_t *alpha, uint8_t *dst, size_t count) {
+    const __m128i spread = _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+    const __m128i opaque = _mm_set1_epi32((int)0xFF000000u);
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        const uint8_t *p = src + 3 * i;
+        __m128i a = _mm_loadu_si128((const __m128i *)p);
+        __m128i b = _mm_loadu_si128((const __m128i *)(p + 16));
+        __m128i c = _mm_loadu_si128((const __m128i *)(p + 32));
+        __m128i groups[4] = {a, _mm_alignr_epi8(b, a, 12), _mm_alignr_epi8(c, b, 8), _mm_srli_si128(c, 4)};
+        __m128i alphas = alpha ? _mm_loadu_si128((const __m128i *)(alpha + i)) : _mm_setzero_si128();
+        uint8_t *q = dst + 4 * i;
+        for (int k = 0; k < 4; k++) {
+            __m128i fourth = opaque;
+            if (alpha) {
+                // octets alpha 4k à 4k + 3 en position 3, 7, 11, 15
+                __m128i place = _mm_setr_epi8(-1, -1, -1, (char)(4 * k), -1, -1, -1, (char)(4 * k + 1),
+                                              -1, -1, -1, (char)(4 * k + 2), -1, -1, -1, (char)(4 * k + 3));
+                fourth = _mm_shuffle_epi8(alphas, place);
+            }
+            __m128i pixels = _mm_or_si128(_mm_shuffle_epi8(groups[k], spread), fourth);
+            _mm_storeu_si128((__m128i *)(q + 16 * k), pixels);
+        }
+    }
+    expand3to4_scalar(src + 3 * i, alpha ? alpha + i : NULL, dst + 4 * i, count - i);
+}
+
+/* ---------------------------------------------------------------------------
+   AVX2 : 32 octets par itération
+   --------------------------------------------------------------------------- */
+
+SIMD_TARGET("avx2")
+static void negate_avx2(uint8_t *data, size_t n) {
+    const __m256i ones = _mm256_set1_epi8((char)0xFF);
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        __m256i v = _mm256_loadu_si256((const __m256i *)(data + i));
+        _mm256_storeu_si256((__m256i *)(data + i), _mm256_xor_si256(v, ones));
+    }
+    negate_scalar(data + i, n - i);
+}
+
+SIMD_TARGET("avx2")
+static void addSaturate_avx2(uint8_t *data, size_t n, int value) {
+    int magnitude = value < 0 ? -value : value;
+    if (magnitude > 255) magnitude = 255;
+    const __m256i delta = _mm256_set1_epi8((char)magnitude);
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        __m256i v = _mm256_loadu_si256((const __m256i *)(data + i));
+        v = value < 0 ? _mm256_subs_epu8(v, delta) : _mm256_adds_epu8(v, delta);
+        _mm256_storeu_si256((__m256i *)(data + i), v);
+    }
+    addSaturate_scalar(data + i, n - i, value);
+}
+
+SIMD_TARGET("avx2")
+static void threshold_avx2(uint8_t *data, size_t n, int threshold) {
+    const __m256i t = _mm256_set1_epi8((char)threshold);
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        __m256i v = _mm256_loadu_si256((const __m256i *)(data + i));
+        _mm256_storeu_si256((__m256i *)(data + i), _mm256_cmpeq_epi8(_mm256_max_epu8(v, t), v));
+    }
+    threshold_scalar(data + i, n - i, threshold);
+}
+
+/*
+Convolution 3x3 AVX2 : 32 pixels par itération (même schéma que la version SSE2)
+- unpack / packs travaillent par voie de 128 bits : packs_epi32 remet les pixels dans l'ordre,
+  seul le packus final demande une permutation
+*/
+SIMD_TARGET("avx2")
+static __m256i convolve3x3_divide_avx2(__m256i acc, const t_simd_divisor *d) {
+    if (d->shift >= 0) {
+        __m256i round = _mm256_set1_epi32(d->divisor >> 1);
+        return _mm256_sra_epi32(_mm256_add_epi32(acc, round), _mm_cvtsi32_si128(d->shift));
+    }
+    const __m256i multiplier = _mm256_set1_epi32((int)d->multiplier);
+    const __m128i count = _mm_cvtsi32_si128(d->mulShift);
+    acc = _mm256_max_epi32(acc, _mm256_setzero_si256());
+    __m256i num = _mm256_add_epi32(_mm256_add_epi32(acc, acc), _mm256_set1_epi32(d->divisor));
+    __m256i even = _mm256_srl_epi64(_mm256_mul_epu32(num, multiplier), count);
+    __m256i odd = _mm256_srl_epi64(_mm256_mul_epu32(_mm256_srli_epi64(num, 32), multiplier), count);
+    return _mm256_or_si256(even, _mm256_slli_epi64(odd, 32));
+}
+
+SIMD_TARGET("avx2")
+static void convolve3x3_avx2(const uint8_t *r0, const uint8_t *r1, const uint8_t *r2,
+                             uint8_t *dst, size_t n, size_t step, const int16_t *w, int32_t divisor) {
+    const uint8_t *rows[3] = {r0, r1, r2};
+    const t_simd_divisor d = convolve3x3_divisor(divisor);
+    __m256i pairs[5];
+    for (int k = 0; k < 5; k++) {
+        int16_t wb = (2 * k + 1 < 9) ? w[2 * k + 1] : 0;
+        pairs[k] = _mm256_set1_epi32((int)(((uint32_t)(uint16_t)wb << 16) | (uint16_t)w[2 * k]));
+    }
+
+    size_t x = 0;
+    for (; x + 32 <= n; x += 32) {
+        __m256i out[2];
+        for (int half = 0; half < 2; half++) {
+            __m256i taps[10];
+            for (int k = 0; k < 9; k++) {
+                __m128i bytes = _mm_loadu_si128((const __m128i *)(rows[k / 3] + x + 16 * half + (k % 3) * step));
+                taps[k] = _mm256_cvtepu8_epi16(bytes);
+            }
+            taps[9] = _mm256_setzero_si256();
+
+            __m256i accLo = _mm256_setzero_si256(), accHi = _mm256_setzero_si256();
+            for (int k = 0; k < 5; k++) {
+                accLo = _mm256_add_epi32(accLo, _mm256_madd_epi16(_mm256_unpacklo_epi16(taps[2 * k], taps[2 * k + 1]), pairs[k]));
+                accHi = _mm256_add_epi32(accHi, _mm256_madd_epi16(_mm256_unpackhi_epi16(taps[2 * k], taps[2 * k + 1]), pairs[k]));
+            }
+            out[half] = _mm256_packs_epi32(convolve3x3_divide_avx2(accLo, &d), convolve3x3_divide_avx2(accHi, &d));
+        }
+        __m256i bytes = _mm256_packus_epi16(out[0], out[1]);
+        _mm256_storeu_si256((__m256i *)(dst + x), _mm256_permute4x64_epi64(bytes, 0xD8));
+    }
+    convolve3x3_scalar(r0 + x, r1 + x, r2 + x, dst + x, n - x, step, w, divisor);
+}
+
+#endif /* SIMD_X86 */
+
+/* ---------------------------------------------------------------------------
+   Détection et aiguillage
+   --------------------------------------------------------------------------- */
+
+typedef struct {
+    void (*negate)(uint8_t *, size_t);
+    void (*addSaturate)(uint8_t *, size_t, int);
+    void (*threshold)(uint8_t *, size_t, int);
+    void (*grayscale3)(uint8_t *, size_t);
+    void (*convolve3x3)(const uint8_t *, const uint8_t *, const uint8_t *, uint8_t *, size_t, size_t,
+                        const int16_t *, int32_t);
+    void (*deinterleave3)(const uint8_t *, uint8_t *, uint8_t *, uint8_t *, size_t);
+    void (*interleave3)(const uint8_t *, const uint8_t *, const uint8_t *, uint8_t *, size_t);
+    void (*average3)(const uint8_t *, const uint8_t *, const uint8_t *, uint8_t *, size_t);
+    void (*compact4to3)(const uint8_t *, uint8_t *, uint8_t *, size_t);
+    void (*expand3to4)(const uint8_t *, const uint8_t *, uint8_t *, size_t);
+} t_simd_ops;
+
+static t_simd_ops simd_ops = {negate_scalar, addSaturate_scalar, threshold_scalar, grayscale3_scalar,
+                              convolve3x3_scalar, deinterleave3_scalar, interleave3_scalar, average3_scalar,
+                              compact4to3_scalar, expand3to4_scalar};
+static t_simd_level simd_current = SIMD_SCALAR;
+static t_simd_level simd_detected = SIMD_SCALAR;
+static int simd_hasSsse3 = 0;
+
+#ifdef SIMD_X86
+static void simd_cpuid(unsigned int leaf, unsigned int sub, unsigned int regs[4]) {
+#if defined(_MSC_VER)
+    __cpuidex((int *)regs, (int)leaf, (int)sub);
+#else
+    __cpuid_count(leaf, sub, regs[0], regs[1], regs[2], regs[3]);
+#endif
+}
+
+// Registre XCR0 : l'OS sauvegarde-t-il les registres YMM ?
+static unsigned long long simd_xgetbv(void) {
+#if defined(_MSC_VER)
+    return _xgetbv(0);
+#else
+    unsigned int lo, hi;
+    __asm__ volatile("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+    return ((unsigned long long)hi << 32) | lo;
+#endif
+}
+#endif
+
+/*
+Détecte le jeu d'instructions (cpuid) et sélectionne les implémentations
+- AVX2 exige aussi le support OS des registres YMM (OSXSAVE + XCR0)
+*/
+void simd_init(void) {
+#ifdef SIMD_X86
+    unsigned int regs[4] = {0, 0, 0, 0};
+    simd_cpuid(0, 0, regs);
+    unsigned int maxLeaf = regs[0];
+
+    simd_cpuid(1, 0, regs);
+    int sse2 = (regs[3] >> 26) & 1;
+    int osxsave = (regs[2] >> 27) & 1;
+    int avx = (regs[2] >> 28) & 1;
+    simd_hasSsse3 = (regs[2] >> 9) & 1;
+
+    int avx2 = 0;
+    if (maxLeaf >= 7 && osxsave && avx && (simd_xgetbv() & 0x6) == 0x6) {
+        simd_cpuid(7, 0, regs);
+        avx2 = (regs[1] >> 5) & 1;
+    }
+
+    simd_detected = avx2 ? SIMD_AVX2 : (sse2 ? SIMD_SSE2 : SIMD_SCALAR);
+#endif
+    simd_setLevel(simd_detected);
+}
+
+/*
+Sélectionne les implémentations d'un niveau donné (borné au niveau détecté)
+*/
+void simd_setLevel(t_simd_level level) {
+    if (level > simd_detected) level = simd_detected;
+    simd_current = level;
+
+    t_simd_ops ops = {negate_scalar, addSaturate_scalar, threshold_scalar, grayscale3_scalar,
+                      convolve3x3_scalar, deinterleave3_scalar, interleave3_scalar, average3_scalar,
+                      compact4to3_scalar, expand3to4_scalar};
+#ifdef SIMD_X86
+    if (level >= SIMD_SSE2) {
+        ops.negate = negate_sse2;
+        ops.addSaturate = addSaturate_sse2;
+        ops.threshold = threshold_sse2;
+        ops.convolve3x3 = convolve3x3_sse2;
+        ops.average3 = average3_sse2;
+        if (simd_hasSsse3) {
+            ops.grayscale3 = grayscale3_ssse3;
+            ops.deinterleave3 = deinterleave3_ssse3;
+            ops.interleave3 = interleave3_ssse3;
+            ops.compact4to3 = compact4to3_ssse3;
+            ops.expand3to4 = expand3to4_ssse3;
+        }
+    }
+    if (level >= SIMD_AVX2) {
+        ops.negate = negate_avx2;
+        ops.addSaturate = addSaturate_avx2;
+        ops.threshold = threshold_avx2;
+        ops.convolve3x3 = convolve3x3_avx2;
+    }
+#endif
+    simd_ops = ops;
+}
+
+t_simd_level simd_getLevel(void) {
+    return simd_current;
+}
+
+t_simd_level simd_getDetectedLevel(void) {
+    return simd_detected;
+}
+
+const char *simd_levelName(t_simd_level level) {
+    switch (level) {
+        case SIMD_AVX2: return "AVX2";
+        case SIMD_SSE2: return "SSE2";
+        default: return "scalaire";
+    }
+}
+
+/*
+Inverse chaque octet (255 - valeur)
+*/
+void simd_negate(uint8_t *data, size_t n) {
+    simd_ops.negate(data, n);
+}
+
+/*
+Ajoute value à chaque octet avec saturation entre 0 et 255
+*/
+void simd_addSaturate(uint8_t *data, size_t n, int value) {
+    if (value == 0) return;
+    simd_ops.addSaturate(data, n, value);
+}
+
+/*
+Seuillage : 255 si octet >= threshold, 0 sinon
+*/
+void simd_threshold(uint8_t *data, size_t n, int threshold) {
+    // Seuils hors de [1, 255] : résultat constant
+    if (threshold <= 0) {
+        memset(data, 255, n);
+        return;
+    }
+    if (threshold > 255) {
+        memset(data, 0, n);
+        return;
+    }
+    simd_ops.threshold(data, n, threshold);
+}
+
+/*
+Convertit des pixels de 3 octets en niveaux de gris (moyenne des 3 composantes)
+*/
+void simd_grayscale3(uint8_t *pixels, size_t count) {
+    simd_ops.grayscale3(pixels, count);
+}
+
+/*
+Convolution 3x3 entière d'une ligne
+- r0, r1, r2 : lignes du dessus, courante et du dessous, décalées d'un pixel vers la gauche
+  (l'octet x de sortie utilise rk[x], rk[x + step], rk[x + 2 step])
+- step : octets entre deux pixels voisins (1 : plan 8 bits, 3 : BGR entrelacé, 4 : BGRX),
+  chaque composante est filtrée avec les composantes de même rang des pixels voisins
+- w : 9 poids 16 bits (ligne par ligne), divisor >= 1 : résultat arrondi au plus proche,
+  identique à kernelDivide (filtres.h) quel que soit le diviseur
+*/
+void simd_convolve3x3(const uint8_t *r0, const uint8_t *r1, const uint8_t *r2,
+                      uint8_t *dst, size_t n, size_t step, const int16_t *w, int32_t divisor) {
+    simd_ops.convolve3x3(r0, r1, r2, dst, n, step, w, divisor);
+}
+
+/*
+Sépare des pixels de 3 octets en trois plans : ck[i] = pixels[3i + k]
+*/
+void simd_deinterleave3(const uint8_t *pixels, uint8_t *c0, uint8_t *c1, uint8_t *c2, size_t count) {
+    simd_ops.deinterleave3(pixels, c0, c1, c2, count);
+}
+
+/*
+Réunit trois plans en pixels de 3 octets : pixels[3i + k] = ck[i]
+*/
+void simd_interleave3(const uint8_t *c0, const uint8_t *c1, const uint8_t *c2, uint8_t *pixels, size_t count) {
+    simd_ops.interleave3(c0, c1, c2, pixels, count);
+}
+
+/*
+Moyenne de trois plans : dst[i] = (a[i] + b[i] + c[i]) / 3 (dst peut être l'un des plans)
+*/
+void simd_average3(const uint8_t *a, const uint8_t *b, const uint8_t *c, uint8_t *dst, size_t n) {
+    simd_ops.average3(a, b, c, dst, n);
+}
+
+/*
+Pixels de 4 octets vers 3 octets : dst[3i + k] = src[4i + k] (k < 3)
+- alpha (si non NULL) reçoit le 4e octet de chaque pixel
+*/
+void simd_compact4to3(const uint8_t *src, uint8_t *dst, uint8_t *alpha, size_t count) {
+    simd_ops.compact4to3(src, dst, alpha, count);
+}
+
+/*
+Pixels de 3 octets vers 4 octets : dst[4i + k] = src[3i + k], dst[4i + 3] = alpha[i] (255 si alpha est NULL)
+*/
+void simd_expand3to4(const uint8_t *src, const uint8_t *alpha, uint8_t *dst, size_t count) {
+    simd_ops.expand3to4(src, alpha, dst, count);
+}
@@ -0,0 +1,45 @@
+#ifndef SIMD_H
+#define SIMD_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Niveaux de jeu d'instructions disponibles pour les traitements point à point
+typedef enum {
+    SIMD_SCALAR = 0,
+    SIMD_SSE2   = 1,
+    SIMD_AVX2   = 2
+} t_simd_level;
+
+// Détection du processeur (cpuid) et choix des implémentations, une fois au démarrage
+// Avant l'appel, les versions scalaires sont utilisées
+void simd_init(void);
+t_simd_level simd_getLevel(void);
+t_simd_level simd_getDetectedLevel(void);
+void simd_setLevel(t_simd_level level);   // force un niveau inférieur (comparaisons, bench)
+const char *simd_levelName(t_simd_level level);
+
+// Traitements sur un tableau d'octets (n octets)
+void simd_negate(uint8_t *data, size_t n);
+void simd_addSaturate(uint8_t *data, size_t n, int value);
+void simd_threshold(uint8_t *data, size_t n, int threshold);
+
+// Niveaux de gris sur des pixels de 3 octets : chaque composante = (c0 + c1 + c2) / 3
+void simd_grayscale3(uint8_t *pixels, size_t count);
+
+// Passage entre pixels de 3 octets et plans séparés (une composante par plan)
+void simd_deinterleave3(const uint8_t *pixels, uint8_t *c0, uint8_t *c1, uint8_t *c2, size_t count);
+void simd_interleave3(const uint8_t *c0, const uint8_t *c1, const uint8_t *c2, uint8_t *pixels, size_t count);
+// Passage entre pixels de 4 octets (BGRX / BGRA, fichiers 32 bits) et de 3 octets
+// alpha : 4e octet de chaque pixel, séparé (NULL : ignoré à la lecture, 255 à l'écriture)
+void simd_compact4to3(const uint8_t *src, uint8_t *dst, uint8_t *alpha, size_t count);
+void simd_expand3to4(const uint8_t *src, const uint8_t *alpha, uint8_t *dst, size_t count);
+// Moyenne de trois plans octet par octet (niveaux de gris sur une image planaire)
+void simd_average3(const uint8_t *a, const uint8_t *b, const uint8_t *c, uint8_t *dst, size_t n);
+
+// Convolution 3x3 entière (poids 16 bits, accumulateurs 32 bits) de n octets d'une ligne,
+// pixels voisins à step octets, division arrondie exacte par divisor (1 à 65536)
+void simd_convolve3x3(const uint8_t *r0, const uint8_t *r1, const uint8_t *r2,
+                      uint8_t *dst, size_t n, size_t step, const int16_t *w, int32_t divisor);
+
+#endif